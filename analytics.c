@@ -0,0 +1,94 @@
+// analytics.c: per-thread win heatmaps and their merge
+
+#include <string.h>
+
+#include "analytics.h"
+
+// empty heatmap for games of one size between two ai levels
+void heatmapInit(Heatmap *map, int size, int xLevel, int oLevel) {
+    memset(map, 0, sizeof(Heatmap));
+    map->size = size;
+    map->xLevel = xLevel;
+    map->oLevel = oLevel;
+}
+
+// is line (index as in Game.winLine) filled with player's marks?
+static int lineFull(const Game *game, int line, char player) {
+    int size = game->size, i;
+
+    for (i = 0; i < size; i++) {
+        int row, col;
+        if (line < size) {
+            row = line; col = i;
+        } else if (line < 2 * size) {
+            row = i; col = line - size;
+        } else if (line == 2 * size) {
+            row = i; col = i;
+        } else {
+            row = i; col = size - 1 - i;
+        }
+        if (game->board[row][col] != player) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// count one finished game; unfinished games are ignored
+// a winning move can complete two to four lines at once (a row and a
+// diagonal, say) while Game.winLine names only one, so every full line
+// through the winning move is counted in lineWins
+void heatmapRecord(Heatmap *map, const Game *game) {
+    int winner, row, col, i;
+    int lines[4];                    // row, column and diagonals through the winning move
+
+    if (game->result == ' ') {
+        return;
+    }
+    map->games++;
+    if (game->result == 'D') {
+        map->draws++;
+        return;
+    }
+
+    winner = playerIndex(game->result);
+    if (winner == 0) {
+        map->xWins++;
+    } else {
+        map->oWins++;
+    }
+    map->cellWins[winner][game->lastMove.row * game->size + game->lastMove.col]++;
+    row = game->lastMove.row;
+    col = game->lastMove.col;
+    lines[0] = row;
+    lines[1] = game->size + col;
+    lines[2] = (row == col) ? 2 * game->size : -1;
+    lines[3] = (row + col == game->size - 1) ? 2 * game->size + 1 : -1;
+    for (i = 0; i < 4; i++) {
+        if (lines[i] >= 0 && lineFull(game, lines[i], game->result)) {
+            map->lineWins[winner][lines[i]]++;
+        }
+    }
+    map->plyWins[winner][game->moveCount]++;
+}
+
+// add every counter of from into into (same size and pairing)
+void heatmapMerge(Heatmap *into, const Heatmap *from) {
+    int p, i;
+
+    into->games += from->games;
+    into->xWins += from->xWins;
+    into->oWins += from->oWins;
+    into->draws += from->draws;
+    for (p = 0; p < 2; p++) {
+        for (i = 0; i < MAX_CELLS; i++) {
+            into->cellWins[p][i] += from->cellWins[p][i];
+        }
+        for (i = 0; i < MAX_LINES; i++) {
+            into->lineWins[p][i] += from->lineWins[p][i];
+        }
+        for (i = 0; i <= MAX_CELLS; i++) {
+            into->plyWins[p][i] += from->plyWins[p][i];
+        }
+    }
+}
@@ -0,0 +1,41 @@
+// analytics.h: where and when games are won, for batch simulations
+//
+// a Heatmap collects, for one board size and one ai pairing, which cell
+// the winning move was played on, which line (row, column or diagonal)
+// it completed and at which ply, separately for x and o wins. each
+// simulation thread fills its own Heatmap, so recording a game is a few
+// plain increments with no locking; heatmapMerge adds the per-thread
+// copies together once the run is over.
+
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include "engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int size;                        // board size of every recorded game
+    int xLevel;                      // ai level playing x
+    int oLevel;                      // ai level playing o
+    long games;
+    long xWins;
+    long oWins;
+    long draws;
+    long cellWins[2][MAX_CELLS];     // [winner][row * size + col] of the winning move
+    long lineWins[2][MAX_LINES];     // [winner][line index, as in Game.winLine]; every line
+                                     // the winning move completed, so a game can add up to 4
+    long plyWins[2][MAX_CELLS + 1];  // [winner][moves played when the game was won]
+} Heatmap;
+
+void heatmapInit(Heatmap *map, int size, int xLevel, int oLevel);
+void heatmapRecord(Heatmap *map, const Game *game);
+void heatmapMerge(Heatmap *into, const Heatmap *from);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+// bench_threats.c: compares the old two-call canWin path in aiMove with
+// the single-pass analyzeThreats on random mid-game positions
+//
+// build: gcc -O2 -std=c99 -o bench_threats bench_threats.c threats.c rng.c
+// usage: ./bench_threats [iterations per size]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "rng.h"
+#include "threats.h"
+
+#define POSITIONS 1024 // random positions per board size
+
+// fill a board with a random legal-looking mid-game position
+// x and o alternate, so counts differ by at most one
+static void randomPosition(char board[MAX_SIZE][MAX_SIZE], int size, Rng *rng) {
+    int i, j, placed, stones;
+    char player = 'X';
+
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            board[i][j] = ' ';
+        }
+    }
+    stones = rngBelow(rng, size * size);  // anywhere from empty to nearly full
+    for (placed = 0; placed < stones; placed++) {
+        do {
+            i = rngBelow(rng, size);
+            j = rngBelow(rng, size);
+        } while (board[i][j] != ' ');
+        board[i][j] = player;
+        player = (player == 'X') ? 'O' : 'X';
+    }
+}
+
+int main(int argc, char *argv[]) {
+    static char boards[POSITIONS][MAX_SIZE][MAX_SIZE];
+    long iterations = (argc > 1) ? atol(argv[1]) : 200000;
+    volatile long sink = 0;  // keeps the compiler from dropping the work
+    Rng rng;
+    int size;
+
+    rngSeed(&rng, 1410);  // fixed seed so runs are comparable
+
+    printf("size   two canWin calls   analyzeThreats   speedup\n");
+    for (size = 3; size <= MAX_SIZE; size++) {
+        clock_t start;
+        double oldNs, newNs;
+        long it;
+        int p;
+
+        for (p = 0; p < POSITIONS; p++) {
+            randomPosition(boards[p], size, &rng);
+        }
+
+        // old path: one canWin call for the ai, one for the opponent
+        start = clock();
+        for (it = 0; it < iterations; it++) {
+            int row, col;
+            p = (int)(it % POSITIONS);
+            sink += canWin(boards[p], size, 'O', &row, &col);
+            sink += canWin(boards[p], size, 'X', &row, &col);
+        }
+        oldNs = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / iterations;
+
+        // new path: every win, block and fork for both players at once
+        start = clock();
+        for (it = 0; it < iterations; it++) {
+            ThreatInfo info;
+            p = (int)(it % POSITIONS);
+            analyzeThreats(boards[p], size, &info);
+            sink += info.winCount[0] + info.winCount[1] + info.forkCount[1];
+        }
+        newNs = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / iterations;
+
+        printf("%2dx%-2d  %13.1f ns  %12.1f ns  %7.2fx\n",
+               size, size, oldNs, newNs, oldNs / newNs);
+    }
+    return (int)(sink & 0);
+}
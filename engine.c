@@ -0,0 +1,466 @@
+// engine.c: game rules, ai and batch calls behind engine.h
+//
+// nothing in here prints or reads input; the front-ends do that.
+// the ai draws random numbers only from the game's own Rng.
+
+#include <stddef.h>
+
+#include "engine.h"
+
+// initialize board by filling all cells with spaces
+void initializeBoard(char board[MAX_SIZE][MAX_SIZE], int size) {
+    int i, j;
+
+    // iterate through all rows
+    for (i = 0; i < size; i++) {
+        // iterate through all columns in each row
+        for (j = 0; j < size; j++) {
+            // mark cell as empty using space character
+            board[i][j] = ' ';
+        }
+    }
+}
+
+// check if a cell is empty
+int isCellEmpty(char board[MAX_SIZE][MAX_SIZE], int row, int col) {
+    return board[row][col] == ' ';
+}
+
+// check if a player has won
+int checkWin(char board[MAX_SIZE][MAX_SIZE], int size, char player) {
+    int i, j;
+    int win;
+    
+    // check all rows for complete win
+    for (i = 0; i < size; i++) {
+        win = 1;                                // assume row is a win
+        for (j = 0; j < size; j++) {
+            if (board[i][j] != player) {
+                win = 0;                       // found non-player mark
+                break;                         // stop checking this row
+            }
+        }
+        if (win) return 1;                     // found winning row!
+    }
+    
+    // check all columns for complete win
+    for (j = 0; j < size; j++) {
+        win = 1;                                // assume column is a win
+        for (i = 0; i < size; i++) {
+            if (board[i][j] != player) {
+                win = 0;                       // found non-player mark
+                break;                         // stop checking this column
+            }
+        }
+        if (win) return 1;                     // found winning column!
+    }
+    
+    // check main diagonal (top-left to bottom-right)
+    win = 1;                                   // assume diagonal is a win
+    for (i = 0; i < size; i++) {
+        if (board[i][i] != player) {
+            win = 0;                           // found non-player mark
+            break;                             // stop checking
+        }
+    }
+    if (win) return 1;                         // found winning diagonal!
+    
+    // check anti-diagonal (top-right to bottom-left)
+    win = 1;                                   // assume diagonal is a win
+    for (i = 0; i < size; i++) {
+        if (board[i][size - 1 - i] != player) {
+            win = 0;                           // found non-player mark
+            break;                             // stop checking
+        }
+    }
+    if (win) return 1;                         // found winning anti-diagonal!
+    
+    return 0;                                  // no winning line found
+}
+
+// check if the game is a draw (board is full)
+int checkDraw(char board[MAX_SIZE][MAX_SIZE], int size) {
+    int i, j;
+    
+    // scan all cells for empty spaces
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (board[i][j] == ' ') {
+                return 0;  // found empty cell, game can continue
+            }
+        }
+    }
+    
+    return 1;              // board is full, it's a draw
+}
+
+// did the mark just placed at (row, col) complete a line?
+// only the row, column and diagonals through that cell can have changed,
+// so this is much cheaper than a full checkWin after every move
+// returns the line index (see Game.winLine) or -1 if no line is complete
+static int completesLine(char board[MAX_SIZE][MAX_SIZE], int size, int row, int col) {
+    char player = board[row][col];
+    int i, rowWin = 1, colWin = 1, diagWin, antiWin;
+
+    for (i = 0; i < size && (rowWin || colWin); i++) {
+        if (board[row][i] != player) rowWin = 0;
+        if (board[i][col] != player) colWin = 0;
+    }
+    if (rowWin) return row;
+    if (colWin) return size + col;
+
+    diagWin = (row == col);                  // only if the cell is on it
+    antiWin = (row + col == size - 1);
+    for (i = 0; i < size && (diagWin || antiWin); i++) {
+        if (board[i][i] != player) diagWin = 0;
+        if (board[i][size - 1 - i] != player) antiWin = 0;
+    }
+    if (diagWin) return 2 * size;
+    if (antiWin) return 2 * size + 1;
+    return -1;
+}
+
+// start a new game on an empty size x size board with x to move
+// returns 0, or -1 if size is outside 3..MAX_SIZE
+int gameInit(Game *game, int size) {
+    if (size < 3 || size > MAX_SIZE) {
+        return -1;
+    }
+    initializeBoard(game->board, size);
+    game->size = size;
+    game->toMove = 'X';
+    game->moveCount = 0;
+    game->result = ' ';
+    game->lastMove.row = game->lastMove.col = -1;
+    game->winLine = -1;
+    rngSeed(&game->rng, 0);
+    return 0;
+}
+
+// pick the ai's random stream: stream number stream of seed
+void gameSeed(Game *game, uint64_t seed, uint64_t stream) {
+    rngSeedStream(&game->rng, seed, stream);
+}
+
+// place the mark of the player to move at (row, col)
+// updates the result and passes the turn; returns MOVE_OK or an error code
+int gameApplyMove(Game *game, int row, int col) {
+    if (game->result != ' ') {
+        return MOVE_GAME_OVER;
+    }
+    if (row < 0 || row >= game->size || col < 0 || col >= game->size) {
+        return MOVE_OUT_OF_BOUNDS;
+    }
+    if (game->board[row][col] != ' ') {
+        return MOVE_OCCUPIED;
+    }
+
+    game->board[row][col] = game->toMove;
+    game->moveCount++;
+    game->lastMove.row = row;
+    game->lastMove.col = col;
+    game->winLine = completesLine(game->board, game->size, row, col);
+    if (game->winLine >= 0) {
+        game->result = game->toMove;
+    } else if (game->moveCount == game->size * game->size) {
+        game->result = 'D';                  // board full, no winner
+    }
+    game->toMove = (game->toMove == 'X') ? 'O' : 'X';
+    return MOVE_OK;
+}
+
+// ' ' while the game is running, 'X' or 'O' for the winner, 'D' for a draw
+char gameResult(const Game *game) {
+    return game->result;
+}
+
+// random empty cell; the game must not be over
+// one draw picks the n-th empty cell, so every empty cell is equally
+// likely and a nearly full board doesn't need repeated tries
+static void randomMove(Game *game, Cell *move) {
+    int size = game->size;
+    int n = rngBelow(&game->rng, size * size - game->moveCount);
+    int i, j;
+
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (game->board[i][j] == ' ' && n-- == 0) {
+                move->row = i;
+                move->col = j;
+                return;
+            }
+        }
+    }
+}
+
+// alpha-beta search (AI_HARD) -------------------------------------------
+
+#define SEARCH_WIN (1 << 28)  // score of a win; faster wins score higher
+                              // (above any evaluator score: see EVAL_MAX_WEIGHT)
+
+// position being searched: a copy of the board plus its evaluator
+typedef struct {
+    char board[MAX_SIZE][MAX_SIZE];
+    int size;
+    int empties;
+    Evaluator eval;
+} SearchState;
+
+// every empty cell, best first by how much it gains for player plus how
+// much it would have gained for the opponent (taking it away from them)
+static int orderByGain(SearchState *st, char player, Cell moves[MAX_CELLS]) {
+    char other = (player == 'X') ? 'O' : 'X';
+    int gains[MAX_CELLS];
+    int n = 0, i, j;
+
+    for (i = 0; i < st->size; i++) {
+        for (j = 0; j < st->size; j++) {
+            Cell cell;
+            int gain, k;
+            if (st->board[i][j] != ' ') {
+                continue;
+            }
+            cell.row = i;
+            cell.col = j;
+            gain = evaluatorGain(&st->eval, i, j, player) + evaluatorGain(&st->eval, i, j, other);
+            // insertion sort: the lists are short and mostly ordered already
+            for (k = n; k > 0 && gains[k - 1] < gain; k--) {
+                gains[k] = gains[k - 1];
+                moves[k] = moves[k - 1];
+            }
+            gains[k] = gain;
+            moves[k] = cell;
+            n++;
+        }
+    }
+    return n;
+}
+
+// negamax with alpha-beta pruning; returns the score from player's side
+// and, at the root (ply 0), the best move in *best
+static int negamax(SearchState *st, char player, int depth, int alpha, int beta, int ply, Cell *best) {
+    char other = (player == 'X') ? 'O' : 'X';
+    int me = playerIndex(player);
+    ThreatInfo threats;
+    Cell moves[MAX_CELLS];
+    int n, i, value;
+
+    // immediate wins and unstoppable double threats end the search here
+    analyzeThreats(st->board, st->size, &threats);
+    if (threats.winCount[me] > 0) {
+        if (best != NULL) *best = threats.wins[me][0];
+        return SEARCH_WIN - ply - 1;
+    }
+    if (st->empties == 0) {
+        return 0;
+    }
+    if (depth == 0 && best == NULL) {
+        return evaluatorScore(&st->eval, player);
+    }
+
+    if (threats.winCount[1 - me] > 0) {
+        moves[0] = threats.wins[1 - me][0];  // forced block (a second threat is lost anyway)
+        n = 1;
+    } else {
+        n = orderByGain(st, player, moves);
+    }
+    if (best != NULL && n > 0) {
+        *best = moves[0];
+    }
+
+    for (i = 0; i < n; i++) {
+        Cell m = moves[i];
+        st->board[m.row][m.col] = player;
+        st->empties--;
+        evaluatorPlay(&st->eval, m.row, m.col, player);
+        value = -negamax(st, other, depth - 1, -beta, -alpha, ply + 1, NULL);
+        evaluatorUndo(&st->eval, m.row, m.col, player);
+        st->empties++;
+        st->board[m.row][m.col] = ' ';
+
+        if (value > alpha) {
+            alpha = value;
+            if (best != NULL) *best = m;
+            if (alpha >= beta) {
+                break;
+            }
+        }
+    }
+    return alpha;
+}
+
+// best move for the player to move by an alpha-beta search depth plies
+// deep, scoring the positions at the depth limit with table (which must
+// be built for the game's size). returns AI_MOVE_WIN for an immediate
+// win, otherwise AI_MOVE_SEARCH; -1 if the game is over or the table is
+// NULL or doesn't fit the game
+int gameSearchMove(const Game *game, const EvalTable *table, int depth, Cell *move) {
+    SearchState st;
+    int i, j;
+
+    if (game->result != ' ' || table == NULL || table->size != game->size || depth < 1) {
+        return -1;
+    }
+    st.size = game->size;
+    st.empties = game->size * game->size - game->moveCount;
+    for (i = 0; i < st.size; i++) {
+        for (j = 0; j < st.size; j++) {
+            st.board[i][j] = game->board[i][j];
+        }
+    }
+    evaluatorInit(&st.eval, table, st.board);
+
+    if (negamax(&st, game->toMove, depth, -SEARCH_WIN, SEARCH_WIN, 0, move) == SEARCH_WIN - 1) {
+        return AI_MOVE_WIN;
+    }
+    return AI_MOVE_SEARCH;
+}
+
+// pick a move for the player to move without playing it
+// table is only read by AI_HARD and must be built for the game's size
+// (the caller builds it once, with default or tuned weights, and can
+// reuse it for every move of every game of that size); other levels
+// take NULL
+// returns one of the AI_MOVE_* reasons, or -1 if the game is over (or
+// AI_HARD has no table that fits)
+int gameChooseAiMove(Game *game, int level, const EvalTable *table, Cell *move) {
+    int size = game->size;
+    int me = playerIndex(game->toMove);      // threat index for the ai
+    int them = 1 - me;                       // threat index for the opponent
+    ThreatInfo threats;
+    int i;
+
+    if (game->result != ' ') {
+        return -1;
+    }
+    if (level == AI_EASY) {
+        randomMove(game, move);
+        return AI_MOVE_RANDOM;
+    }
+    if (level == AI_HARD) {
+        return gameSearchMove(game, table, AI_HARD_DEPTH, move);
+    }
+
+    // one pass over every line finds wins, blocks and forks for both sides
+    analyzeThreats(game->board, size, &threats);
+
+    // strategy 1: try to win immediately
+    if (threats.winCount[me] > 0) {
+        *move = threats.wins[me][0];
+        return AI_MOVE_WIN;
+    }
+
+    // strategy 2: block opponent's winning move
+    if (threats.winCount[them] > 0) {
+        *move = threats.wins[them][0];
+        return AI_MOVE_BLOCK;
+    }
+
+    // strategy 3: create two threats at once (opponent can only block one)
+    if (threats.forkCount[me] > 0) {
+        *move = threats.forks[me][0];
+        return AI_MOVE_FORK;
+    }
+
+    // strategy 4: take the opponent's fork cell before they can
+    if (threats.forkCount[them] > 0) {
+        *move = threats.forks[them][0];
+        return AI_MOVE_FORK_BLOCK;
+    }
+
+    // strategy 5: take center if available (only odd-sized boards have one)
+    if (size % 2 == 1 && isCellEmpty(game->board, size / 2, size / 2)) {
+        move->row = size / 2;
+        move->col = size / 2;
+        return AI_MOVE_CENTER;
+    }
+
+    // strategy 6: take a corner (strategic positions)
+    int corners[4][2] = {{0, 0}, {0, size-1}, {size-1, 0}, {size-1, size-1}};
+    for (i = 0; i < 4; i++) {
+        if (isCellEmpty(game->board, corners[i][0], corners[i][1])) {
+            move->row = corners[i][0];
+            move->col = corners[i][1];
+            return AI_MOVE_CORNER;
+        }
+    }
+
+    // strategy 7: pick random empty cell (fallback)
+    randomMove(game, move);
+    return AI_MOVE_RANDOM;
+}
+
+// apply moves[i] to games[i] for every game, writing each status code
+// returns the number of moves that were legal and played
+int gameApplyMoves(Game games[], const Cell moves[], int count, int status[]) {
+    int i, played = 0;
+
+    for (i = 0; i < count; i++) {
+        status[i] = gameApplyMove(&games[i], moves[i].row, moves[i].col);
+        if (status[i] == MOVE_OK) {
+            played++;
+        }
+    }
+    return played;
+}
+
+// choose an ai move for every game; reasons[i] is -1 for finished games
+// reasons may be NULL if the caller doesn't need them
+// table is shared by every game (see gameChooseAiMove), so AI_HARD
+// batches must hold games of one size
+void gameChooseAiMoves(Game games[], int count, int level, const EvalTable *table,
+                       Cell moves[], int reasons[]) {
+    int i, reason;
+
+    for (i = 0; i < count; i++) {
+        reason = gameChooseAiMove(&games[i], level, table, &moves[i]);
+        if (reasons != NULL) {
+            reasons[i] = reason;
+        }
+    }
+}
+
+// let the ai play one move in every unfinished game (table as in
+// gameChooseAiMoves)
+// returns the number of games still in progress afterwards
+int gamePlayAiMoves(Game games[], int count, int level, const EvalTable *table) {
+    Cell move;
+    int i, running = 0;
+
+    for (i = 0; i < count; i++) {
+        if (gameChooseAiMove(&games[i], level, table, &move) >= 0) {
+            gameApplyMove(&games[i], move.row, move.col);
+        }
+        if (games[i].result == ' ') {
+            running++;
+        }
+    }
+    return running;
+}
+
+// copy the result of every game into results
+void gameResults(const Game games[], int count, char results[]) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        results[i] = games[i].result;
+    }
+}
+
+// reset all counters to zero
+void initializeScore(Score *score) {
+    score->xWins = 0;
+    score->oWins = 0;
+    score->draws = 0;
+}
+
+// update score based on game outcome
+void updateScore(Score *score, char winner) {
+    if (winner == 'X') {
+        score->xWins++;   // increment player x's wins
+    } else if (winner == 'O') {
+        score->oWins++;   // increment player o's wins
+    } else if (winner == 'D') {
+        score->draws++;   // increment draw count
+    }
+}
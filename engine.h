@@ -0,0 +1,107 @@
+// engine.h: tic-tac-toe game engine shared by every front-end
+//
+// the engine holds all of the game rules and the ai, with no global
+// variables and no console input/output, so it can be linked into the
+// interactive programs (mainp1.c, mainp2.c), batch simulations or other
+// c/c++ code. all state lives in Game and Score structures owned by the
+// caller. the batch calls take an array of games and do the same thing
+// to each of them, so a caller driving thousands of games pays the call
+// overhead once per batch instead of once per game.
+//
+// every Game carries its own random stream for the ai. gameInit seeds it
+// with a fixed seed; call gameSeed afterwards to choose the seed and the
+// stream (e.g. the game number), which makes every game replayable and
+// lets games on different threads draw numbers without sharing state.
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "eval.h"
+#include "rng.h"
+#include "threats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ai difficulty levels
+#define AI_EASY   1  // random empty cell
+#define AI_MEDIUM 2  // win, block, forks, center, corners, then random
+#define AI_HARD   3  // alpha-beta search with the pattern-table evaluator
+
+#define AI_HARD_DEPTH 4  // plies searched by AI_HARD
+
+// why the ai chose its move (returned by gameChooseAiMove)
+#define AI_MOVE_WIN          1
+#define AI_MOVE_BLOCK        2
+#define AI_MOVE_FORK         3
+#define AI_MOVE_FORK_BLOCK   4
+#define AI_MOVE_CENTER       5
+#define AI_MOVE_CORNER       6
+#define AI_MOVE_RANDOM       7
+#define AI_MOVE_POSITIONAL   8  // best-scoring quiet move (sparse boards)
+#define AI_MOVE_THREAT       9  // first move of a forced win found by threat-space search
+#define AI_MOVE_THREAT_BLOCK 10 // spoils the opponent's forced win (sparse boards)
+#define AI_MOVE_SEARCH       11 // best move of the alpha-beta search (AI_HARD)
+
+// gameApplyMove status codes
+#define MOVE_OK             0
+#define MOVE_OUT_OF_BOUNDS -1
+#define MOVE_OCCUPIED      -2
+#define MOVE_GAME_OVER     -3
+#define MOVE_NO_MEMORY     -4  // sparse boards only: the stone table couldn't grow
+#define MOVE_EMPTY         -5  // sparse boards only: sparseUndo of a cell with no stone
+
+// one game in progress
+typedef struct {
+    char board[MAX_SIZE][MAX_SIZE];  // ' ' for empty, 'X' or 'O'
+    int size;                        // board is size x size
+    char toMove;                     // player to move next ('X' starts)
+    int moveCount;                   // marks placed so far
+    char result;                     // ' ' while playing, 'X'/'O' winner, 'D' draw
+    Cell lastMove;                   // most recent move, (-1, -1) before the first
+    int winLine;                     // completed line: rows 0..size-1, columns
+                                     // size..2*size-1, 2*size main diagonal,
+                                     // 2*size+1 anti-diagonal; -1 if none. if the
+                                     // winning move completed several lines, only
+                                     // the first in that order is recorded
+    Rng rng;                         // random stream of the ai in this game
+} Game;
+
+// cumulative results over several games
+typedef struct {
+    int xWins;
+    int oWins;
+    int draws;
+} Score;
+
+// board-level helpers (full scans of the board)
+void initializeBoard(char board[MAX_SIZE][MAX_SIZE], int size);
+int isCellEmpty(char board[MAX_SIZE][MAX_SIZE], int row, int col);
+int checkWin(char board[MAX_SIZE][MAX_SIZE], int size, char player);
+int checkDraw(char board[MAX_SIZE][MAX_SIZE], int size);
+
+// single games
+int gameInit(Game *game, int size);
+void gameSeed(Game *game, uint64_t seed, uint64_t stream);
+int gameApplyMove(Game *game, int row, int col);
+char gameResult(const Game *game);
+int gameChooseAiMove(Game *game, int level, const EvalTable *table, Cell *move);
+int gameSearchMove(const Game *game, const EvalTable *table, int depth, Cell *move);
+
+// batches of games; moves[i], status[i], results[i] belong to games[i]
+int gameApplyMoves(Game games[], const Cell moves[], int count, int status[]);
+void gameChooseAiMoves(Game games[], int count, int level, const EvalTable *table,
+                       Cell moves[], int reasons[]);
+int gamePlayAiMoves(Game games[], int count, int level, const EvalTable *table);
+void gameResults(const Game games[], int count, char results[]);
+
+// scores
+void initializeScore(Score *score);
+void updateScore(Score *score, char winner);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+// eval.c: line-code tables and incremental position scores (see eval.h)
+
+#include <stdlib.h>
+
+#include "eval.h"
+
+// 1, 4, 16, ...: each extra mark on an open line is worth four times more
+void evalDefaultWeights(int size, int weights[MAX_SIZE + 1]) {
+    int n;
+
+    weights[0] = 0;
+    for (n = 1; n <= MAX_SIZE; n++) {
+        weights[n] = (n <= size) ? 1 << (2 * (n - 1)) : 0;
+    }
+}
+
+// read "n weight" pairs from a weights file held in text into weights
+// returns the number of pairs read, or -1 on a malformed line, an n
+// outside 1..size or a weight outside 0..EVAL_MAX_WEIGHT
+int evalParseWeights(const char *text, int size, int weights[MAX_SIZE + 1]) {
+    const char *p = text;
+    int pairs = 0;
+
+    while (*p != '\0') {
+        char *end;
+        long n, weight;
+
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (*p == '#') {
+            while (*p != '\0' && *p != '\n') p++;   // comment line
+            continue;
+        }
+        n = strtol(p, &end, 10);
+        if (end == p || n < 1 || n > size) {
+            return -1;
+        }
+        p = end;
+        weight = strtol(p, &end, 10);
+        if (end == p || weight < 0 || weight > EVAL_MAX_WEIGHT) {
+            return -1;
+        }
+        p = end;
+        weights[n] = (int)weight;
+        pairs++;
+    }
+    return pairs;
+}
+
+// build the score of every line code of one size; weights may be NULL
+// for the defaults. returns 0, or -1 for a bad size, a weight outside
+// 0..EVAL_MAX_WEIGHT or out of memory
+int evalTableInit(EvalTable *table, int size, const int weights[MAX_SIZE + 1]) {
+    int codes, code, i;
+
+    if (size < 3 || size > MAX_SIZE) {
+        return -1;
+    }
+    table->size = size;
+    if (weights != NULL) {
+        for (i = 0; i <= MAX_SIZE; i++) {
+            if (weights[i] < 0 || weights[i] > EVAL_MAX_WEIGHT) {
+                return -1;
+            }
+            table->weights[i] = weights[i];
+        }
+    } else {
+        evalDefaultWeights(size, table->weights);
+    }
+    table->pow3[0] = 1;
+    for (i = 1; i <= MAX_SIZE; i++) {
+        table->pow3[i] = table->pow3[i - 1] * 3;
+    }
+    codes = table->pow3[size];
+    table->fullLine[0] = (codes - 1) / 2;  // 111...1 in base 3
+    table->fullLine[1] = codes - 1;        // 222...2
+    table->scores = malloc(codes * sizeof(int));
+    if (table->scores == NULL) {
+        return -1;
+    }
+
+    for (code = 0; code < codes; code++) {
+        int digits = code, x = 0, o = 0;
+        for (i = 0; i < size; i++, digits /= 3) {
+            x += (digits % 3 == 1);
+            o += (digits % 3 == 2);
+        }
+        if (o == 0) {
+            table->scores[code] = table->weights[x];
+        } else if (x == 0) {
+            table->scores[code] = -table->weights[o];
+        } else {
+            table->scores[code] = 0;  // both players: nobody can complete it
+        }
+    }
+    return 0;
+}
+
+void evalTableFree(EvalTable *table) {
+    free(table->scores);
+    table->scores = NULL;
+}
+
+// the lines through (row, col) and the cell's place in each
+// returns how many there are (2 to 4)
+static int linesThrough(int size, int row, int col, int lines[4], int places[4]) {
+    int n = 0;
+
+    lines[n] = row;            places[n++] = col;   // row
+    lines[n] = size + col;     places[n++] = row;   // column
+    if (row == col) {
+        lines[n] = 2 * size;   places[n++] = row;   // main diagonal
+    }
+    if (row + col == size - 1) {
+        lines[n] = 2 * size + 1; places[n++] = row; // anti-diagonal
+    }
+    return n;
+}
+
+// code and score every line of board (the only full scan)
+void evaluatorInit(Evaluator *eval, const EvalTable *table, char board[MAX_SIZE][MAX_SIZE]) {
+    int size = table->size;
+    int i, j, l;
+
+    eval->table = table;
+    for (l = 0; l < 2 * size + 2; l++) {
+        eval->codes[l] = 0;
+    }
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            int lines[4], places[4], n;
+            int digit = (board[i][j] == 'X') ? 1 : (board[i][j] == 'O') ? 2 : 0;
+            if (digit == 0) {
+                continue;
+            }
+            n = linesThrough(size, i, j, lines, places);
+            for (l = 0; l < n; l++) {
+                eval->codes[lines[l]] += digit * table->pow3[places[l]];
+            }
+        }
+    }
+    eval->score = 0;
+    for (l = 0; l < 2 * size + 2; l++) {
+        eval->score += table->scores[eval->codes[l]];
+    }
+}
+
+// player marks the empty cell (row, col): update its lines and the score
+// returns 1 if that completes a line (a win), otherwise 0
+int evaluatorPlay(Evaluator *eval, int row, int col, char player) {
+    const EvalTable *table = eval->table;
+    int p = playerIndex(player);
+    int lines[4], places[4], n, l, won = 0;
+
+    n = linesThrough(table->size, row, col, lines, places);
+    for (l = 0; l < n; l++) {
+        int *code = &eval->codes[lines[l]];
+        eval->score -= table->scores[*code];
+        *code += (p + 1) * table->pow3[places[l]];
+        eval->score += table->scores[*code];
+        won |= (*code == table->fullLine[p]);
+    }
+    return won;
+}
+
+// take back player's mark at (row, col)
+void evaluatorUndo(Evaluator *eval, int row, int col, char player) {
+    const EvalTable *table = eval->table;
+    int p = playerIndex(player);
+    int lines[4], places[4], n, l;
+
+    n = linesThrough(table->size, row, col, lines, places);
+    for (l = 0; l < n; l++) {
+        int *code = &eval->codes[lines[l]];
+        eval->score -= table->scores[*code];
+        *code -= (p + 1) * table->pow3[places[l]];
+        eval->score += table->scores[*code];
+    }
+}
+
+// how much playing (row, col) would change the score, from player's side
+int evaluatorGain(const Evaluator *eval, int row, int col, char player) {
+    const EvalTable *table = eval->table;
+    int p = playerIndex(player);
+    int lines[4], places[4], n, l, gain = 0;
+
+    n = linesThrough(table->size, row, col, lines, places);
+    for (l = 0; l < n; l++) {
+        int code = eval->codes[lines[l]];
+        gain += table->scores[code + (p + 1) * table->pow3[places[l]]] - table->scores[code];
+    }
+    return (p == 0) ? gain : -gain;
+}
+
+// score of the position from player's side (positive is good for player)
+int evaluatorScore(const Evaluator *eval, char player) {
+    return (player == 'X') ? eval->score : -eval->score;
+}
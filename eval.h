@@ -0,0 +1,65 @@
+// eval.h: pattern-table static evaluation of tic-tac-toe positions
+//
+// every row, column and diagonal is kept as a base-3 line code (cell i
+// of the line adds 0, 1 or 2 times 3^i for empty, x or o), and an
+// EvalTable maps every possible code of one board size straight to a
+// score. an Evaluator holds the codes of all lines of one position and
+// their summed score; playing or taking back a mark touches only the
+// two to four lines through that cell, so a search gets its leaf values
+// from a few table lookups instead of scanning the board.
+//
+// the scores come from per-size weights: weights[n] is the value of a
+// line holding n marks of one player and none of the other's (positive
+// for x, negative for o; lines with both are dead and score 0). the
+// weights can be tuned offline from games against the random ai (see
+// tune_eval.c) and are stored as text, parsed by evalParseWeights:
+//   # comment
+//   1 1
+//   2 4        <- "n weight", one pair per line
+// counts that are not listed keep their default weight. weights must lie
+// in 0..EVAL_MAX_WEIGHT: a position score is a sum over at most MAX_LINES
+// lines, and it has to stay well below the score the search gives a win.
+
+#ifndef EVAL_H
+#define EVAL_H
+
+#include "threats.h"
+
+#define EVAL_MAX_WEIGHT (1 << 22)  // MAX_LINES of these sum to a third of the win score
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// line score lookup for one board size
+typedef struct {
+    int size;
+    int weights[MAX_SIZE + 1];  // weights[n]: n marks of one player on an open line
+    int *scores;                // 3^size entries, indexed by line code, from x's side
+    int pow3[MAX_SIZE + 1];     // 3^i, the code step of cell i of a line
+    int fullLine[2];            // codes of a line filled by x / by o
+} EvalTable;
+
+// line codes and running score of one position
+typedef struct {
+    const EvalTable *table;
+    int codes[MAX_LINES];       // rows, columns, main and anti-diagonal (as in Game.winLine)
+    int score;                  // sum of table->scores over every line, from x's side
+} Evaluator;
+
+void evalDefaultWeights(int size, int weights[MAX_SIZE + 1]);
+int evalParseWeights(const char *text, int size, int weights[MAX_SIZE + 1]);
+int evalTableInit(EvalTable *table, int size, const int weights[MAX_SIZE + 1]);
+void evalTableFree(EvalTable *table);
+
+void evaluatorInit(Evaluator *eval, const EvalTable *table, char board[MAX_SIZE][MAX_SIZE]);
+int evaluatorPlay(Evaluator *eval, int row, int col, char player);
+void evaluatorUndo(Evaluator *eval, int row, int col, char player);
+int evaluatorGain(const Evaluator *eval, int row, int col, char player);
+int evaluatorScore(const Evaluator *eval, char player);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,502 @@
+// fuzz_kernels.c: differential fuzzing of the fast kernels against the
+// plain char-grid reference logic
+//
+// every case is a random legal game on a random size (3-10) with a
+// random k for the k-in-a-row variant. after every move each optimized
+// kernel is compared with a straightforward reference:
+// - gameApplyMove's incremental result/winLine  vs  checkWin / checkDraw
+// - analyzeThreats wins and forks               vs  canWin and a trial mark in each cell
+//                                                   (every TRIAL_EVERY-th position)
+// - orderMoves                                  vs  the list of empty cells
+// - SparseBoard k-in-a-row wins                 vs  a full scan of the grid
+// - PackedBoard / rank / canonical form         vs  the board array
+// - Evaluator incremental score and win flag    vs  recounting every line
+// on a mismatch the move sequence is shrunk (cut after the failing
+// position, then x/o pairs of moves dropped while the failure still
+// reproduces) and printed with the seed.
+//
+// usage: ./fuzz_kernels [--seconds S] [--cases N] [--seed N]
+// exits with 1 if any kernel disagrees with the reference
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "engine.h"
+#include "eval.h"
+#include "position.h"
+#include "rng.h"
+#include "sparse.h"
+
+#define MESSAGE_LENGTH 160
+#define TRIAL_EVERY    4    // positions per run of the slow trial-move threat reference
+
+static EvalTable tables[MAX_SIZE + 1];  // default-weight table of every size
+
+// one fuzz case: a board size, a k and the moves to play (x first)
+typedef struct {
+    int size;
+    int k;
+    Cell moves[MAX_CELLS];
+    int count;
+} Case;
+
+// ---------------------------------------------------------------- reference
+
+// cells of line number line (same numbering as Game.winLine)
+static void lineCell(int size, int line, int i, int *row, int *col) {
+    if (line < size) { *row = line; *col = i; }
+    else if (line < 2 * size) { *row = i; *col = line - size; }
+    else if (line == 2 * size) { *row = i; *col = i; }
+    else { *row = i; *col = size - 1 - i; }
+}
+
+// does player own every cell of the line?
+static int refLineOwned(char board[MAX_SIZE][MAX_SIZE], int size, int line, char player) {
+    int i, row, col;
+    for (i = 0; i < size; i++) {
+        lineCell(size, line, i, &row, &col);
+        if (board[row][col] != player) return 0;
+    }
+    return 1;
+}
+
+// does the line through (row, col) hold size-1 of player's marks and one empty cell?
+static int refLineThreat(char board[MAX_SIZE][MAX_SIZE], int size, int line, char player,
+                         int row, int col) {
+    int i, r, c, mine = 0, empty = 0, through = 0;
+    for (i = 0; i < size; i++) {
+        lineCell(size, line, i, &r, &c);
+        if (r == row && c == col) through = 1;
+        if (board[r][c] == player) mine++;
+        else if (board[r][c] == ' ') empty++;
+    }
+    return through && mine == size - 1 && empty == 1;
+}
+
+// marks of each player and empty cells on every line (numbered as Game.winLine)
+static void refLineCounts(char board[MAX_SIZE][MAX_SIZE], int size,
+                          int marks[2][MAX_LINES], int empty[MAX_LINES]) {
+    int line, i, row, col;
+
+    for (line = 0; line < 2 * size + 2; line++) {
+        marks[0][line] = marks[1][line] = empty[line] = 0;
+        for (i = 0; i < size; i++) {
+            lineCell(size, line, i, &row, &col);
+            if (board[row][col] == 'X') marks[0][line]++;
+            else if (board[row][col] == 'O') marks[1][line]++;
+            else empty[line]++;
+        }
+    }
+}
+
+// k or more of player's marks in a row anywhere on the grid
+static int refKInRow(char board[MAX_SIZE][MAX_SIZE], int size, int k, char player) {
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    int row, col, d, i;
+
+    for (row = 0; row < size; row++) {
+        for (col = 0; col < size; col++) {
+            for (d = 0; d < 4; d++) {
+                for (i = 0; i < k; i++) {
+                    int r = row + i * directions[d][0], c = col + i * directions[d][1];
+                    if (r < 0 || r >= size || c < 0 || c >= size || board[r][c] != player) break;
+                }
+                if (i == k) return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// evaluator score from scratch: weights of every line held by one player only
+static int refEvalScore(char board[MAX_SIZE][MAX_SIZE], int size, const int weights[]) {
+    int line, i, row, col, score = 0;
+
+    for (line = 0; line < 2 * size + 2; line++) {
+        int x = 0, o = 0;
+        for (i = 0; i < size; i++) {
+            lineCell(size, line, i, &row, &col);
+            x += (board[row][col] == 'X');
+            o += (board[row][col] == 'O');
+        }
+        if (o == 0) score += weights[x];
+        else if (x == 0) score -= weights[o];
+    }
+    return score;
+}
+
+static int cellListed(const Cell cells[], int count, int row, int col) {
+    int i;
+    for (i = 0; i < count; i++) {
+        if (cells[i].row == row && cells[i].col == col) return 1;
+    }
+    return 0;
+}
+
+// ------------------------------------------------------------------ checks
+
+// threat kernels on the current position; returns 0 and fills message on a mismatch
+// with trial set, every empty cell is tried on the board: a mark is placed
+// and checkWin and the lines through the cell decide win and fork. that
+// reference shares nothing with analyzeThreats but costs O(n^4), so
+// otherwise the answers come from per-line mark counts, which only catch
+// slips in how the kernel applies its rule (lists, duplicates, cells)
+static int checkThreats(char board[MAX_SIZE][MAX_SIZE], int size, int trial, char *message) {
+    ThreatInfo info;
+    Cell moves[MAX_CELLS];
+    int seen[MAX_SIZE][MAX_SIZE];
+    int marks[2][MAX_LINES], empty[MAX_LINES];
+    int p, row, col, line, n, i, empties = 0, wins, forks;
+    int lines[4];  // row, column and (if on them) the diagonals through a cell
+
+    analyzeThreats(board, size, &info);
+    refLineCounts(board, size, marks, empty);
+    for (p = 0; p < 2; p++) {
+        char player = (p == 0) ? 'X' : 'O';
+        int r, c;
+
+        // canWin agrees on whether there is a win, and its cell is listed
+        if (canWin(board, size, player, &r, &c) != (info.winCount[p] > 0)) {
+            sprintf(message, "analyzeThreats/canWin disagree on a win for %c", player);
+            return 0;
+        }
+        if (info.winCount[p] > 0 && !cellListed(info.wins[p], info.winCount[p], r, c)) {
+            sprintf(message, "canWin cell (%d,%d) for %c missing from analyzeThreats", r, c, player);
+            return 0;
+        }
+
+        // every empty cell: is it a win, a fork, both or neither?
+        wins = forks = 0;
+        for (row = 0; row < size; row++) {
+            for (col = 0; col < size; col++) {
+                int isWin = 0, threats = 0;
+                if (board[row][col] != ' ') continue;
+                lines[0] = row;
+                lines[1] = size + col;
+                lines[2] = (row == col) ? 2 * size : -1;
+                lines[3] = (row + col == size - 1) ? 2 * size + 1 : -1;
+                if (trial) {
+                    // threats this move would create (lines with one empty cell left)
+                    board[row][col] = player;
+                    isWin = checkWin(board, size, player);
+                    for (i = 0; i < 4; i++) {
+                        if (lines[i] >= 0) {
+                            threats += refLineThreat(board, size, lines[i], player, row, col);
+                        }
+                    }
+                    board[row][col] = ' ';
+                } else {
+                    // a mark only changes the lines through it: it wins if one
+                    // holds size-1 of the player's marks, and threatens on each
+                    // one left with size-1 marks and one empty cell
+                    for (i = 0; i < 4; i++) {
+                        line = lines[i];
+                        if (line < 0) continue;
+                        isWin |= (marks[p][line] == size - 1);
+                        threats += (marks[p][line] == size - 2 && empty[line] == 2);
+                    }
+                }
+                if (isWin != cellListed(info.wins[p], info.winCount[p], row, col)) {
+                    sprintf(message, "analyzeThreats win list wrong at (%d,%d) for %c", row, col, player);
+                    return 0;
+                }
+                if ((threats >= 2) != cellListed(info.forks[p], info.forkCount[p], row, col)) {
+                    sprintf(message, "analyzeThreats fork list wrong at (%d,%d) for %c", row, col, player);
+                    return 0;
+                }
+                wins += isWin;
+                forks += (threats >= 2);
+            }
+        }
+        if (wins != info.winCount[p] || forks != info.forkCount[p]) {
+            sprintf(message, "analyzeThreats lists duplicates for %c", player);
+            return 0;
+        }
+    }
+
+    // orderMoves: every empty cell exactly once
+    memset(seen, 0, sizeof(seen));
+    for (row = 0; row < size; row++) {
+        for (col = 0; col < size; col++) {
+            empties += (board[row][col] == ' ');
+        }
+    }
+    n = orderMoves(board, size, 'X', &info, moves);
+    if (n != empties) {
+        sprintf(message, "orderMoves returned %d moves for %d empty cells", n, empties);
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        Cell m = moves[i];
+        if (board[m.row][m.col] != ' ' || seen[m.row][m.col]++) {
+            sprintf(message, "orderMoves listed (%d,%d) twice or occupied", m.row, m.col);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// packed encodings round-trip and agree across a symmetry
+static int checkPacked(char board[MAX_SIZE][MAX_SIZE], int size, int symmetry, char *message) {
+    char copy[MAX_SIZE][MAX_SIZE], turned[MAX_SIZE][MAX_SIZE];
+    PackedBoard packed, other, canonical, otherCanonical;
+    int row, col, r, c;
+
+    packBoard(board, size, &packed);
+    unpackBoard(&packed, size, copy);
+    for (row = 0; row < size; row++) {
+        for (col = 0; col < size; col++) {
+            if (copy[row][col] != board[row][col] || packedGet(&packed, size, row, col) != board[row][col]) {
+                sprintf(message, "packBoard/unpackBoard changed cell (%d,%d)", row, col);
+                return 0;
+            }
+            transformCell(size, symmetry, row, col, &r, &c);
+            turned[r][c] = board[row][col];
+        }
+    }
+    if (size <= RANK_MAX_SIZE) {
+        unrankPacked(rankPacked(&packed, size), size, &other);
+        if (packedCompare(&packed, &other) != 0) {
+            sprintf(message, "rankPacked/unrankPacked round trip failed");
+            return 0;
+        }
+    } else if (rankPacked(&packed, size) != RANK_INVALID) {
+        sprintf(message, "rankPacked accepted size %d", size);
+        return 0;
+    }
+    packBoard(turned, size, &other);
+    canonicalPacked(&packed, size, &canonical);
+    canonicalPacked(&other, size, &otherCanonical);
+    if (packedCompare(&canonical, &otherCanonical) != 0) {
+        sprintf(message, "canonicalPacked differs under symmetry %d", symmetry);
+        return 0;
+    }
+    return 1;
+}
+
+// play the case and compare every kernel on every position
+// the trial-move threat reference runs on every trialEvery-th position
+// positions (if not NULL) gets the number of positions checked
+// returns the number of moves played before the position that failed a
+// check, or -1 if every check passed
+static int runCase(const Case *test, int symmetry, int trialEvery, long *positions, char *message) {
+    Game game;
+    SparseBoard sparse;
+    Evaluator eval;
+    char board[MAX_SIZE][MAX_SIZE];
+    int size = test->size;
+    int sparseOpen = 1;  // the k-in-a-row game may end before the full-line one
+    int step, failedAt = -1;
+    long checked = 0;
+
+    gameInit(&game, size);
+    initializeBoard(board, size);
+    evaluatorInit(&eval, &tables[size], board);
+    if (sparseInit(&sparse, test->k) != 0) {
+        sprintf(message, "sparseInit failed");
+        return 0;
+    }
+
+    // threats mean nothing past a win, so a finished game stops the case
+    for (step = 0; game.result == ' '; step++) {
+        Cell move;
+        char player = game.toMove;
+        int won, before;
+
+        // the position after step moves, before the next one is played
+        if (!checkThreats(board, size, step % trialEvery == 0, message)) {
+            failedAt = step;
+            break;
+        }
+        checked++;
+        if (step == test->count) {
+            break;
+        }
+
+        // the rest checks the position the move leads to
+        move = test->moves[step];
+        failedAt = step + 1;
+        // incremental result vs full scans
+        if (gameApplyMove(&game, move.row, move.col) != MOVE_OK) {
+            sprintf(message, "gameApplyMove rejected a legal move");
+            break;
+        }
+        board[move.row][move.col] = player;
+        won = checkWin(board, size, player);
+        if ((game.result == player) != won) {
+            sprintf(message, "gameApplyMove result '%c', checkWin says %d", game.result, won);
+            break;
+        }
+        if (!won && (game.result == 'D') != checkDraw(board, size)) {
+            sprintf(message, "gameApplyMove result '%c', checkDraw disagrees", game.result);
+            break;
+        }
+        if (won && !refLineOwned(board, size, game.winLine, player)) {
+            sprintf(message, "winLine %d is not a complete line", game.winLine);
+            break;
+        }
+
+        // incremental evaluation vs a recount, and undo restores the score
+        before = eval.score;
+        if (evaluatorPlay(&eval, move.row, move.col, player) != won) {
+            sprintf(message, "evaluatorPlay win flag disagrees with checkWin");
+            break;
+        }
+        if (eval.score != refEvalScore(board, size, tables[size].weights)) {
+            sprintf(message, "evaluator score %d, recount %d", eval.score,
+                    refEvalScore(board, size, tables[size].weights));
+            break;
+        }
+        evaluatorUndo(&eval, move.row, move.col, player);
+        if (eval.score != before) {
+            sprintf(message, "evaluatorUndo left score %d, expected %d", eval.score, before);
+            break;
+        }
+        evaluatorPlay(&eval, move.row, move.col, player);
+
+        // k-in-a-row on the sparse board vs a scan of the grid
+        if (sparseOpen) {
+            if (sparsePlay(&sparse, move.row, move.col) != MOVE_OK
+                || sparseGet(&sparse, move.row, move.col) != player) {
+                sprintf(message, "sparsePlay lost the move");
+                break;
+            }
+            if ((sparse.result == player) != refKInRow(board, size, test->k, player)) {
+                sprintf(message, "sparse k=%d result '%c' disagrees with grid scan", test->k, sparse.result);
+                break;
+            }
+            sparseOpen = (sparse.result == ' ');
+        }
+
+        if (!checkPacked(board, size, symmetry, message)) break;
+        failedAt = -1;
+    }
+
+    sparseFree(&sparse);
+    if (positions != NULL) {
+        *positions = checked;
+    }
+    return failedAt;
+}
+
+// the case without move x (an x move) and move o (an o move)
+// the other moves keep their colour and their order among that colour's
+// moves, which dropping a single move or an adjacent pair would not do for
+// every move after it
+static void dropPair(const Case *from, int x, int o, Case *to) {
+    Cell xMoves[MAX_CELLS], oMoves[MAX_CELLS];
+    int xCount = 0, oCount = 0, i;
+
+    for (i = 0; i < from->count; i++) {
+        if (i == x || i == o) continue;
+        if (i % 2 == 0) xMoves[xCount++] = from->moves[i];
+        else oMoves[oCount++] = from->moves[i];
+    }
+    to->size = from->size;
+    to->k = from->k;
+    to->count = xCount + oCount;
+    for (i = 0; i < to->count; i++) {
+        to->moves[i] = (i % 2 == 0) ? xMoves[i / 2] : oMoves[i / 2];
+    }
+}
+
+// shorten a failing case while it still fails: the moves after the failure
+// are cut first, then x/o pairs of moves are dropped. every candidate runs
+// the trial-move reference on every position
+static void shrink(Case *test, int symmetry, int failedAt, char *message) {
+    Case smaller;
+    int x, o, result, changed = 1;
+
+    test->count = failedAt;
+    while (changed) {
+        changed = 0;
+        for (x = 0; x < test->count; x += 2) {
+            for (o = 1; o < test->count; o += 2) {
+                dropPair(test, x, o, &smaller);
+                result = runCase(&smaller, symmetry, 1, NULL, message);
+                if (result >= 0) {
+                    *test = smaller;
+                    test->count = result;
+                    changed = 1;
+                    o = -1;  // the moves have moved: start the o moves over
+                }
+            }
+        }
+    }
+    runCase(test, symmetry, 1, NULL, message);  // leave the message of the final case
+}
+
+int main(int argc, char *argv[]) {
+    Case test;
+    char message[MESSAGE_LENGTH];
+    uint64_t seed = (uint64_t)time(NULL);
+    Rng rng;  // one stream for the whole run, so the seed replays it
+    double seconds = 10;
+    long maxCases = 0;  // 0 = run until the time is up
+    long cases = 0, positions = 0;
+    clock_t start = clock();
+    int i;
+
+    for (i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--seconds") == 0) seconds = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--cases") == 0) maxCases = atol(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[i + 1], NULL, 10);
+    }
+    rngSeed(&rng, seed);
+    printf("fuzz_kernels: seed %llu\n", (unsigned long long)seed);
+    for (i = 3; i <= MAX_SIZE; i++) {
+        if (evalTableInit(&tables[i], i, NULL) != 0) {
+            printf("Out of memory.\n");
+            return 1;
+        }
+    }
+
+    for (;;) {
+        int cells, j, failedAt, symmetry;
+        long checked;
+
+        if (maxCases > 0 ? cases >= maxCases
+                         : (double)(clock() - start) / CLOCKS_PER_SEC >= seconds) {
+            break;
+        }
+
+        // random size, k and a shuffled order of every cell
+        test.size = 3 + rngBelow(&rng, MAX_SIZE - 2);
+        test.k = 3 + rngBelow(&rng, test.size - 2);
+        cells = test.size * test.size;
+        for (j = 0; j < cells; j++) {
+            test.moves[j].row = j / test.size;
+            test.moves[j].col = j % test.size;
+        }
+        for (j = cells - 1; j > 0; j--) {
+            int other = rngBelow(&rng, j + 1);
+            Cell swap = test.moves[j];
+            test.moves[j] = test.moves[other];
+            test.moves[other] = swap;
+        }
+        test.count = cells;
+        symmetry = rngBelow(&rng, SYMMETRIES);
+
+        failedAt = runCase(&test, symmetry, TRIAL_EVERY, &checked, message);
+        cases++;
+        if (failedAt >= 0) {
+            shrink(&test, symmetry, failedAt, message);
+            printf("MISMATCH after %ld cases: %s\n", cases, message);
+            printf("size %d, k %d, symmetry %d, %d moves:", test.size, test.k, symmetry, test.count);
+            for (j = 0; j < test.count; j++) {
+                printf(" %c(%d,%d)", (j % 2 == 0) ? 'X' : 'O', test.moves[j].row, test.moves[j].col);
+            }
+            printf("\nreplay with --seed %llu\n", (unsigned long long)seed);
+            return 1;
+        }
+        positions += checked;
+    }
+
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%ld games, %ld positions checked in %.1f s (%.0f games/min, %.0f positions/min), no mismatches\n",
+           cases, positions, seconds, cases / seconds * 60, positions / seconds * 60);
+    return 0;
+}
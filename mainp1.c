@@ -11,26 +11,19 @@
 
 // include necessary headers
 #include <stdio.h>  // for input/output operations (printf, scanf)
-#include <stdlib.h> // for standard library functions (rand, srand, malloc)
+#include <stdlib.h> // for strtoull (the --seed option)
+#include <string.h> // for strcmp (the --seed option)
 #include <time.h>   // for time-based random seed (time function)
 
-#define MAX_SIZE 10 // maximum grid size constant (allows grids up to 10x10)
-
-// global variables for score tracking across multiple game rounds
-// these maintain cumulative scores throughout the entire session
-int playerXScore = 0; // tracks total wins for player x
-int playerOScore = 0; // tracks total wins for player o
-int draws = 0;        // tracks total draw games
+#include "engine.h" // game rules, ai and score tracking (engine library)
 
 // ==================== function prototypes - week 1 basic functionality ====================
 // function declarations allow main() to call these functions before their definitions appear
-void initializeBoard(char board[MAX_SIZE][MAX_SIZE], int size);
+// board setup, win/draw detection and score updates come from the engine
+// library (engine.c); this file only handles the console side of the game
 void printBoard(char board[MAX_SIZE][MAX_SIZE], int size);
-void playerMove(char board[MAX_SIZE][MAX_SIZE], int size, char player);
-void aiMove(char board[MAX_SIZE][MAX_SIZE], int size, char aiPlayer);
-int checkWin(char board[MAX_SIZE][MAX_SIZE], int size, char player);
-int checkDraw(char board[MAX_SIZE][MAX_SIZE], int size);
-void updateScore(char winner);
+void playerMove(Game *game);
+void aiMove(Game *game);
 
 // ==================== main function ====================
 // purpose: serves as the entry point and main control flow of the program
@@ -39,18 +32,28 @@ void updateScore(char winner);
 // responsibility: handle player input for game setup
 // responsibility: coordinate between player moves, ai moves, and win/draw detection
 // responsibility: manage score tracking and rematch functionality
-int main() {
+int main(int argc, char *argv[]) {
     // local variables declaration for game state management
-    char board[MAX_SIZE][MAX_SIZE]; // 2d array representing the game board
+    Game game;         // board, player to move and result of the current game
+    Score score;       // cumulative scores across every round of the session
     int size;          // user-selected grid size (3-10)
     int gameMode;      // selected game mode (1: pvp, 2: pva)
     char currentPlayer; // tracks whose turn it is ('x' or 'o')
-    int gameOver;      // boolean flag: 1 if game ended, 0 if ongoing
     char playAgain;    // user input for rematch (y/n)
+    uint64_t seed;     // random seed of this session (current time or --seed)
+    uint64_t gamesStarted = 0; // each game gets its own random stream
     
     // seed random number generator using current time
     // this ensures different random ai moves on each program run
-    srand(time(NULL));
+    // "mainp1 --seed N" replays the ai moves of an earlier session
+    seed = (uint64_t)time(NULL);
+    if (argc > 2 && strcmp(argv[1], "--seed") == 0) {
+        seed = strtoull(argv[2], NULL, 10);
+    }
+    // on stderr, so the seed of any session can be found for --seed
+    fprintf(stderr, "Random seed: %llu\n", (unsigned long long)seed);
+    // start every score counter at zero
+    initializeScore(&score);
     
     printf("===================================\n");
     printf("  TIC-TAC-TOE GAME - WEEK 1\n");
@@ -85,15 +88,11 @@ int main() {
             }
         } while (gameMode != 1 && gameMode != 2); // repeat until valid input
         
-        // initialize a fresh board with all empty cells
+        // initialize a fresh game with all empty cells
         // must do this before each new game
-        initializeBoard(board, size);
-        
-        // set starting player to x
         // x always goes first in tic-tac-toe
-        currentPlayer = 'X';
-        // initialize game state flag: 0 = game ongoing, 1 = game ended
-        gameOver = 0;
+        gameInit(&game, size);
+        gameSeed(&game, seed, gamesStarted++);
         
         // display game start message
         printf("\n--- Game Start! ---\n");
@@ -105,61 +104,48 @@ int main() {
         printf("\n");
         
         // main game loop: continues until someone wins or draw occurs
-        while (!gameOver) {
+        // gameResult is ' ' while the game is still being played
+        while (gameResult(&game) == ' ') {
             // display current board state to players
-            printBoard(board, size);
+            printBoard(game.board, size);
             
             // determine whose turn it is and execute appropriate move
+            // the engine switches players after every move
+            currentPlayer = game.toMove;
             // if pvp mode or if it's player x's turn: human makes move
             if (gameMode == 1 || currentPlayer == 'X') {
                 // human player's turn
                 printf("\nPlayer %c's turn:\n", currentPlayer);
                 // get validated move input from human player
-                playerMove(board, size, currentPlayer);
+                playerMove(&game);
             } else {
                 // ai player's turn (player o in pva mode)
                 printf("\nAI (O) is thinking...\n");
                 // execute ai move (random in week 1, strategic in week 2)
-                aiMove(board, size, 'O');
-            }
-            
-            // check if current player's last move resulted in a win
-            // checkwin returns 1 if winning condition met, 0 otherwise
-            if (checkWin(board, size, currentPlayer)) {
-                // display final board state
-                printBoard(board, size);
-                // announce winner
-                printf("\n*** Player %c wins! ***\n\n", currentPlayer);
-                // update global score counters
-                updateScore(currentPlayer);
-                // set flag to end game loop
-                gameOver = 1;
-            }
-            // if no win, check if game board is completely filled (draw)
-            else if (checkDraw(board, size)) {
-                // display final board state
-                printBoard(board, size);
-                // announce draw
-                printf("\n*** It's a draw! ***\n\n");
-                // update draw counter in global scores
-                updateScore('D');
-                // set flag to end game loop
-                gameOver = 1;
-            }
-            // if no win or draw, alternate to other player
-            else {
-                // ternary operator: switch x to o or o to x
-                currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
+                aiMove(&game);
             }
         }
         
+        // the engine checked for a win or a full board after the last move
+        // display final board state
+        printBoard(game.board, size);
+        if (gameResult(&game) == 'D') {
+            // announce draw
+            printf("\n*** It's a draw! ***\n\n");
+        } else {
+            // announce winner
+            printf("\n*** Player %c wins! ***\n\n", gameResult(&game));
+        }
+        // update the score counters ('X', 'O' or 'D' for a draw)
+        updateScore(&score, gameResult(&game));
+        
         // display current scores after game ends
         printf("===================================\n");
         printf("         SCORE BOARD\n");
         printf("===================================\n");
-        printf("Player X: %d\n", playerXScore); // show x's cumulative wins
-        printf("Player O: %d\n", playerOScore); // show o's cumulative wins
-        printf("Draws:    %d\n", draws);         // show total draws
+        printf("Player X: %d\n", score.xWins); // show x's cumulative wins
+        printf("Player O: %d\n", score.oWins); // show o's cumulative wins
+        printf("Draws:    %d\n", score.draws); // show total draws
         printf("===================================\n\n");
         
         // ask if players want to play another round
@@ -172,7 +158,7 @@ int main() {
     // program closing message
     printf("Thank you for playing!\n");
     // display final cumulative scores
-    printf("Final Scores - X: %d, O: %d, Draws: %d\n", playerXScore, playerOScore, draws);
+    printf("Final Scores - X: %d, O: %d, Draws: %d\n", score.xWins, score.oWins, score.draws);
     
     // return 0 to indicate successful program termination
     return 0;
@@ -180,24 +166,6 @@ int main() {
 
 // ==================== function implementations ====================
 
-// function: initializeBoard
-// purpose: set up a fresh game board with all empty cells
-// parameter: board - 2d array to be initialized (passed by reference)
-// parameter: size - dimension of the board (size x size grid)
-// return: void (modifies board in place)
-// notes: must be called at the start of each new game
-void initializeBoard(char board[MAX_SIZE][MAX_SIZE], int size) {
-    // outer loop iterates through all rows
-    int i, j;
-    for (i = 0; i < size; i++) {
-        // inner loop iterates through all columns in current row
-        for (j = 0; j < size; j++) {
-            // set each cell to empty space character
-            board[i][j] = ' ';
-        }
-    }
-}
-
 // function: printBoard
 // purpose: display the current state of the game board to the console
 // parameter: board - 2d array containing current board state (passed by reference)
@@ -245,17 +213,17 @@ void printBoard(char board[MAX_SIZE][MAX_SIZE], int size) {
 
 // function: playerMove
 // purpose: get move input from human player with input validation
-// parameter: board - 2d array to place move on (passed by reference)
-// parameter: size - board dimension for boundary checking
-// parameter: player - 'x' or 'o' to place on board
-// return: void (modifies board in place)
-// notes: validates row/column bounds and cell availability before accepting move
-void playerMove(char board[MAX_SIZE][MAX_SIZE], int size, char player) {
-    int row, col;           // coordinates for the move
-    int validMove = 0;      // flag: 0 = invalid, 1 = valid and placed
+// parameter: game - game to place the move in (passed by reference)
+// return: void (modifies the game in place)
+// notes: the engine validates row/column bounds and cell availability
+// notes: before accepting the move and reports which check failed
+void playerMove(Game *game) {
+    int row, col;                    // coordinates for the move
+    int status = MOVE_OUT_OF_BOUNDS; // engine's answer: MOVE_OK once placed
+    int size = game->size;           // board dimension for the prompts
     
     // loop until player provides valid move
-    while (!validMove) {
+    while (status != MOVE_OK) {
         // get row coordinate from player
         printf("Enter row (0-%d): ", size - 1);
         scanf("%d", &row);
@@ -263,161 +231,32 @@ void playerMove(char board[MAX_SIZE][MAX_SIZE], int size, char player) {
         printf("Enter column (0-%d): ", size - 1);
         scanf("%d", &col);
         
-        // validate that row and column are within board boundaries
-        if (row < 0 || row >= size || col < 0 || col >= size) {
-            // give feedback if coordinates are out of bounds
+        // try to place the move; the engine rejects bad coordinates
+        status = gameApplyMove(game, row, col);
+        // give feedback if coordinates are out of bounds
+        if (status == MOVE_OUT_OF_BOUNDS) {
             printf("Invalid input! Row and column must be between 0 and %d.\n", size - 1);
         }
-        // validate that selected cell is empty (not already occupied)
-        else if (board[row][col] != ' ') {
+        // selected cell is already occupied
+        else if (status == MOVE_OCCUPIED) {
             printf("Cell already occupied! Choose another cell.\n");
         }
-        // if both validations pass, place move and exit loop
-        else {
-            board[row][col] = player; // mark board with player's symbol
-            validMove = 1;            // set flag to exit loop
-        }
     }
 }
 
 // function: aiMove
 // purpose: generate ai move for week 1 (random placement only)
-// parameter: board - 2d array to place ai move on (passed by reference)
-// parameter: size - board dimension for random coordinate generation
-// parameter: aiPlayer - 'x' or 'o' (typically 'o' as ai opponent to player x)
-// return: void (modifies board in place)
-// notes: week 1 implementation uses simple random move selection
-// notes: week 2 will add strategic logic for winning and blocking moves
-void aiMove(char board[MAX_SIZE][MAX_SIZE], int size, char aiPlayer) {
-    int row, col;
+// parameter: game - game to place the ai move in (passed by reference)
+// return: void (modifies the game in place)
+// notes: week 1 implementation uses the engine's easy level (random cell)
+// notes: week 2 (mainp2.c) uses the medium level for winning and blocking moves
+void aiMove(Game *game) {
+    Cell move; // cell chosen by the engine
     
     // week 1 strategy: simple random move generation
-    // keep generating random coordinates until an empty cell is found
-    do {
-        // generate random row: 0 to size-1
-        row = rand() % size;
-        // generate random column: 0 to size-1
-        col = rand() % size;
-        // repeat if selected cell is not empty
-    } while (board[row][col] != ' ');
-    
+    gameChooseAiMove(game, AI_EASY, NULL, &move);
     // place ai mark on the randomly selected empty cell
-    board[row][col] = aiPlayer;
+    gameApplyMove(game, move.row, move.col);
     // display ai's move to the player
-    printf("AI plays at row %d, column %d (random move)\n", row, col);
-}
-
-// function: checkWin
-// purpose: determine if a player has achieved winning condition
-// parameter: board - 2d array representing current board state (passed by reference)
-// parameter: size - board dimension for checking all winning patterns
-// parameter: player - character ('x' or 'o') of player to check win for
-// return: int (1 if win detected, 0 if no win)
-// notes: checks all possible winning combinations (rows, cols, diagonals)
-// notes: must be called after each move to determine game status
-int checkWin(char board[MAX_SIZE][MAX_SIZE], int size, char player) {
-    int i, j;
-    int win; // flag for checking a particular line
-    
-    // check all rows for a complete line of player's marks
-    for (i = 0; i < size; i++) {
-        win = 1; // assume row is winning until proven otherwise
-        for (j = 0; j < size; j++) {
-            // if any cell in row doesn't match player, row is not a win
-            if (board[i][j] != player) {
-                win = 0;
-                break; // exit inner loop early since row failed
-            }
-        }
-        // if row passed all checks, player has won
-        if (win) return 1;
-    }
-    
-    // check all columns for a complete line of player's marks
-    for (j = 0; j < size; j++) {
-        win = 1; // assume column is winning until proven otherwise
-        for (i = 0; i < size; i++) {
-            // if any cell in column doesn't match player, column is not a win
-            if (board[i][j] != player) {
-                win = 0;
-                break; // exit inner loop early since column failed
-            }
-        }
-        // if column passed all checks, player has won
-        if (win) return 1;
-    }
-    
-    // check main diagonal (top-left to bottom-right)
-    // main diagonal has coordinates (0,0), (1,1), (2,2), ..., (size-1, size-1)
-    win = 1; // assume diagonal is winning until proven otherwise
-    for (i = 0; i < size; i++) {
-        // if any diagonal cell doesn't match player, diagonal is not a win
-        if (board[i][i] != player) {
-            win = 0;
-            break; // exit loop early since diagonal failed
-        }
-    }
-    // if diagonal passed all checks, player has won
-    if (win) return 1;
-    
-    // check anti-diagonal (top-right to bottom-left)
-    // anti-diagonal has coordinates (0, size-1), (1, size-2), ..., (size-1, 0)
-    win = 1; // assume anti-diagonal is winning until proven otherwise
-    for (i = 0; i < size; i++) {
-        // if any anti-diagonal cell doesn't match player, it's not a win
-        if (board[i][size - 1 - i] != player) {
-            win = 0;
-            break; // exit loop early since anti-diagonal failed
-        }
-    }
-    // if anti-diagonal passed all checks, player has won
-    if (win) return 1;
-    
-    // if no winning condition found in any direction, no win yet
-    return 0;
-}
-
-// function: checkDraw
-// purpose: determine if the game board is completely filled without a winner
-// parameter: board - 2d array representing current board state (passed by reference)
-// parameter: size - board dimension for checking all cells
-// return: int (1 if draw condition detected, 0 if empty cells remain)
-// notes: called after win check fails to determine game outcome
-// notes: draw = no empty spaces remain AND no player has won
-int checkDraw(char board[MAX_SIZE][MAX_SIZE], int size) {
-    int i, j;
-    
-    // scan entire board for any empty cells
-    for (i = 0; i < size; i++) {
-        for (j = 0; j < size; j++) {
-            // if an empty cell is found, game is not a draw
-            if (board[i][j] == ' ') {
-                return 0; // found an empty cell, game is not over
-            }
-        }
-    }
-    
-    // if loop completes without finding empty cells, board is full
-    return 1; // no empty cells found, board is completely filled
-}
-
-// function: updateScore
-// purpose: increment the score counter for the winning player or draws
-// parameter: winner - 'x' (player x won), 'o' (player o won), or 'd' (draw)
-// return: void (modifies global score variables)
-// notes: global variables (playerXScore, playerOScore, draws) are modified
-// notes: scores persist across multiple game rounds within a session
-void updateScore(char winner) {
-    // check if player x won this round
-    if (winner == 'X') {
-        playerXScore++; // increment x's win counter
-    }
-    // check if player o won this round
-    else if (winner == 'O') {
-        playerOScore++; // increment o's win counter
-    }
-    // check if game ended in a draw
-    else if (winner == 'D') {
-        draws++; // increment draw counter
-    }
+    printf("AI plays at row %d, column %d (random move)\n", move.row, move.col);
 }
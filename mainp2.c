@@ -11,16 +11,14 @@
 // ai heuristics) and to explain more subtle or non-obvious lines.
 
 // include necessary libraries
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-#define MAX_SIZE 10 // maximum grid size
-
-// global variables for score tracking
-int playerXScore = 0;    // tracks wins for player x
-int playerOScore = 0;    // tracks wins for player o
-int draws = 0;           // tracks number of draw games
+#include "engine.h"
+#include "solver.h"
 
 // function prototypes
 // function prototypes with explanatory notes
@@ -29,38 +27,56 @@ int draws = 0;           // tracks number of draw games
 // functions in the file doesn't matter. each function is described in
 // detail where it is implemented, but here's a quick map of what each
 // function does and why it exists:
-// - initializeBoard: fills the 2D array with spaces to mark empty cells.
 // - printBoard: prints a nicely formatted grid. useful separation of
 //               concerns (display vs. game logic).
 // - playerMove: prompts the user for a move and validates input.
-// - aiMove: simple rule-based ai (tries to win, blocks opponent, takes
-//           center/corners, otherwise random) — good teaching example
-// - canWin: checks if a player can win on the next move; used by ai.
-// - isCellEmpty: helper to test whether a cell is unoccupied.
-// - checkWin/checkDraw: terminal checks used to determine game state.
-// - updateScore: increments the appropriate global score counter.
-void initializeBoard(char board[MAX_SIZE][MAX_SIZE], int size);
+// - aiMove: asks the engine for a move at the chosen difficulty (easy:
+//           random; medium: tries to win, blocks opponent, plays or
+//           blocks forks, takes center/corners, otherwise random; hard:
+//           alpha-beta search), plays it and says why it was chosen.
+// - loadWeights: reads the tuned evaluation weights for a board size
+//                from weights/<size>.txt (written by tune_eval).
+// - loadPosition/solveCommand: "solve" command line mode that proves a
+//                  saved position a win, loss or draw (solver.c).
+// the game rules themselves (initializeBoard, checkWin, checkDraw,
+// updateScore, ...) live in the engine library (engine.c) so every
+// front-end shares one copy of them.
 void printBoard(char board[MAX_SIZE][MAX_SIZE], int size);
-void playerMove(char board[MAX_SIZE][MAX_SIZE], int size, char player);
-void aiMove(char board[MAX_SIZE][MAX_SIZE], int size, char aiPlayer);
-int checkWin(char board[MAX_SIZE][MAX_SIZE], int size, char player);
-int checkDraw(char board[MAX_SIZE][MAX_SIZE], int size);
-void updateScore(char winner);
-int canWin(char board[MAX_SIZE][MAX_SIZE], int size, char player, int *row, int *col);
-int isCellEmpty(char board[MAX_SIZE][MAX_SIZE], int row, int col);
+void playerMove(Game *game);
+void aiMove(Game *game, int level, const EvalTable *table);
+int loadWeights(int size, int weights[MAX_SIZE + 1]);
+int loadPosition(const char *source, char board[MAX_SIZE][MAX_SIZE], int *size);
+int solveCommand(int argc, char *argv[]);
 
 // main function
-int main() {
-    char board[MAX_SIZE][MAX_SIZE];
+// "mainp2 solve ..." runs the solver instead of the interactive game
+int main(int argc, char *argv[]) {
+    Game game;
+    Score score;
     int size;
     int gameMode;
+    int level = AI_MEDIUM;   // ai difficulty (AI_EASY, AI_MEDIUM or AI_HARD)
+    int weights[MAX_SIZE + 1];
+    EvalTable table;         // line scores for the hard ai, rebuilt per game
     char currentPlayer;
-    int gameOver;
     char playAgain;
+    uint64_t seed;
+    uint64_t gamesStarted = 0;
+    
+    if (argc > 1 && strcmp(argv[1], "solve") == 0) {
+        return solveCommand(argc - 2, argv + 2);
+    }
     
     // seed random number generator with current time
     // ensures different random moves each game run
-    srand(time(NULL));
+    // "mainp2 --seed N" replays the ai moves of an earlier session
+    seed = (uint64_t)time(NULL);
+    if (argc > 2 && strcmp(argv[1], "--seed") == 0) {
+        seed = strtoull(argv[2], NULL, 10);
+    }
+    // on stderr, so the seed of any session can be found for --seed
+    fprintf(stderr, "Random seed: %llu\n", (unsigned long long)seed);
+    initializeScore(&score);
     
     printf("===================================\n");
     printf("  TIC-TAC-TOE GAME WITH AI (somewhat anyway)\n");
@@ -88,12 +104,38 @@ int main() {
             }
         } while (gameMode != 1 && gameMode != 2);      // repeat until valid
         
-        // fill all board cells with space characters
-        initializeBoard(board, size);
+        // get ai difficulty (pvai only)
+        if (gameMode == 2) {
+            do {
+                printf("\nSelect AI difficulty:\n");
+                printf("1. Easy (random moves)\n");
+                printf("2. Medium (rule-based)\n");
+                printf("3. Hard (searches ahead)\n");
+                printf("Enter your choice (1-3): ");
+                scanf("%d", &level);
+                if (level < AI_EASY || level > AI_HARD) {
+                    printf("Invalid choice! Please enter 1, 2 or 3.\n");
+                }
+            } while (level < AI_EASY || level > AI_HARD);
+        }
+        
+        // empty board, x plays first, game is not over
+        gameInit(&game, size);
+        gameSeed(&game, seed, gamesStarted++);   // one random stream per game
         
-        // initialize game state: x plays first, game is not over
-        currentPlayer = 'X';  // set x as the starting player
-        gameOver = 0;         // game has not ended yet
+        // hard ai: tuned weights for this size if there is a file, else defaults
+        if (gameMode == 2 && level == AI_HARD) {
+            evalDefaultWeights(size, weights);
+            if (loadWeights(size, weights) < 0) {
+                printf("weights/%d.txt is malformed or has a weight outside 0..%d, using default weights.\n",
+                       size, EVAL_MAX_WEIGHT);
+                evalDefaultWeights(size, weights);
+            }
+            if (evalTableInit(&table, size, weights) != 0) {
+                printf("Not enough memory for the hard AI, playing medium.\n");
+                level = AI_MEDIUM;
+            }
+        }
         
         printf("\n--- Game Start! ---\n");
         if (gameMode == 2) {
@@ -102,48 +144,43 @@ int main() {
         printf("\n");
         
         // main game loop - continues until someone wins or draw occurs
-        while (!gameOver) {
+        while (gameResult(&game) == ' ') {
             // display current board state
-            printBoard(board, size);
+            printBoard(game.board, size);
             
             // determine whose turn it is and get their move
+            currentPlayer = game.toMove;
             if (gameMode == 1 || currentPlayer == 'X') {
                 // human player turn (in pvp, always human; in pvai, x is human)
                 printf("\nPlayer %c's turn:\n", currentPlayer);  // announce player
-                playerMove(board, size, currentPlayer);          // get their move
+                playerMove(&game);                               // get their move
             } else {
                 // ai turn (only in pvai mode when o's turn)
                 printf("\nAI (O) is thinking...\n");              // announce ai
-                aiMove(board, size, 'O');                        // ai plays
-            }
-            
-            // check if current player has won
-            if (checkWin(board, size, currentPlayer)) {
-                printBoard(board, size);                         // show final board
-                printf("\n*** Player %c wins! ***\n\n", currentPlayer);
-                updateScore(currentPlayer);                      // increment winner's score
-                gameOver = 1;                                    // end the game
-            }
-            // check if game is a draw
-            else if (checkDraw(board, size)) {
-                printBoard(board, size);                         // show final board
-                printf("\n*** It's a draw! ***\n\n");
-                updateScore('D');                                // increment draw count
-                gameOver = 1;                                    // end the game
-            }
-            // game continues: switch to other player
-            else {
-                currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';  // toggle player
+                aiMove(&game, level, (level == AI_HARD) ? &table : NULL);  // ai plays
             }
         }
         
+        // the engine switches players and checks for a win or a draw
+        // after every move, so all that's left is to report the result
+        printBoard(game.board, size);                            // show final board
+        if (gameResult(&game) == 'D') {
+            printf("\n*** It's a draw! ***\n\n");
+        } else {
+            printf("\n*** Player %c wins! ***\n\n", gameResult(&game));
+        }
+        updateScore(&score, gameResult(&game));                  // winner's score or draw count
+        if (gameMode == 2 && level == AI_HARD) {
+            evalTableFree(&table);
+        }
+        
         // display accumulated scores
         printf("===================================\n");
         printf("         SCORE BOARD\n");         // title
         printf("===================================\n");
-        printf("Player X: %d\n", playerXScore);  // x's total wins
-        printf("Player O: %d\n", playerOScore);  // o's total wins
-        printf("Draws:    %d\n", draws);         // total draws
+        printf("Player X: %d\n", score.xWins);   // x's total wins
+        printf("Player O: %d\n", score.oWins);   // o's total wins
+        printf("Draws:    %d\n", score.draws);   // total draws
         printf("===================================\n\n");
         
         // ask if player wants another game
@@ -154,25 +191,11 @@ int main() {
     } while (playAgain == 'y' || playAgain == 'Y');
     
     printf("Thank you for playing!\n");
-    printf("Final Scores - X: %d, O: %d, Draws: %d\n", playerXScore, playerOScore, draws);
+    printf("Final Scores - X: %d, O: %d, Draws: %d\n", score.xWins, score.oWins, score.draws);
     
     return 0;
 }
 
-// initialize board by filling all cells with spaces
-void initializeBoard(char board[MAX_SIZE][MAX_SIZE], int size) {
-    int i, j;
-
-    // iterate through all rows
-    for (i = 0; i < size; i++) {
-        // iterate through all columns in each row
-        for (j = 0; j < size; j++) {
-            // mark cell as empty using space character
-            board[i][j] = ' ';
-        }
-    }
-}
-
 // display the current state of the board
 void printBoard(char board[MAX_SIZE][MAX_SIZE], int size) {
     int i, j;
@@ -212,259 +235,222 @@ void printBoard(char board[MAX_SIZE][MAX_SIZE], int size) {
 }
 
 // get a valid move from the player with input validation
-void playerMove(char board[MAX_SIZE][MAX_SIZE], int size, char player) {
+void playerMove(Game *game) {
     int row, col;
-    int validMove = 0;  // flag to exit validation loop
+    int status = MOVE_OUT_OF_BOUNDS;  // engine's answer for the last attempt
+    int size = game->size;
     
     // keep asking until valid move is made
-    while (!validMove) {
+    while (status != MOVE_OK) {
         printf("Enter row (0-%d): ", size - 1);      // prompt for row
         scanf("%d", &row);                            // read row input
         printf("Enter column (0-%d): ", size - 1);  // prompt for column
         scanf("%d", &col);                            // read column input
         
-        // check if row/column are within bounds
-        if (row < 0 || row >= size || col < 0 || col >= size) {
+        // the engine places the mark if the cell is on the board and empty
+        status = gameApplyMove(game, row, col);
+        if (status == MOVE_OUT_OF_BOUNDS) {
             printf("Invalid input! Row and column must be between 0 and %d.\n", size - 1);
-        } 
-        // check if cell is already occupied
-        else if (board[row][col] != ' ') {
+        } else if (status == MOVE_OCCUPIED) {
             printf("Cell already occupied! Choose another cell.\n");
-        } 
-        // valid move: place player's mark and exit loop
-        else {
-            board[row][col] = player;  // place the player's mark
-            validMove = 1;              // exit the validation loop
         }
     }
 }
 
-// check if a cell is empty
-int isCellEmpty(char board[MAX_SIZE][MAX_SIZE], int row, int col) {
-    return board[row][col] == ' ';
+// enhanced ai move with strategic decision-making
+// table holds the line scores for the hard level (NULL otherwise)
+void aiMove(Game *game, int level, const EvalTable *table) {
+    Cell move;
+    int reason;
+    
+    reason = gameChooseAiMove(game, level, table, &move);
+    
+    gameApplyMove(game, move.row, move.col);   // place the ai's mark
+    printf("AI plays at row %d, column %d", move.row, move.col);
+    if (reason == AI_MOVE_WIN) {
+        printf(" (Winning move!)");
+    } else if (reason == AI_MOVE_BLOCK) {
+        printf(" (Blocking move!)");
+    } else if (reason == AI_MOVE_FORK) {
+        printf(" (Fork move!)");
+    } else if (reason == AI_MOVE_FORK_BLOCK) {
+        printf(" (Fork block!)");
+    } else if (reason == AI_MOVE_CENTER) {
+        printf(" (Center move!)");
+    } else if (reason == AI_MOVE_CORNER) {
+        printf(" (Corner move!)");
+    } else if (reason == AI_MOVE_SEARCH) {
+        printf(" (Best move found by search)");
+    }
+    printf("\n");
+}
+
+// read the tuned evaluation weights for size from weights/<size>.txt
+// into weights (counts missing from the file keep their value)
+// returns the number of weights read, 0 if there is no file, -1 if it is malformed
+int loadWeights(int size, int weights[MAX_SIZE + 1]) {
+    char path[32];
+    char text[1024];
+    size_t length;
+    FILE *file;
+    
+    sprintf(path, "weights/%d.txt", size);
+    file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    length = fread(text, 1, sizeof(text) - 1, file);
+    text[length] = '\0';
+    fclose(file);
+    return evalParseWeights(text, size, weights);
 }
 
-// check if a player can win in the next move
-// returns 1 if win is possible and sets row and col to winning position
-int canWin(char board[MAX_SIZE][MAX_SIZE], int size, char player, int *row, int *col) {
+// read a position from a save file or a board string
+// save files use the saveGame format (size, then one line per row).
+// if source isn't a readable file it is parsed as a board string: the
+// rows separated by '/', using X, O and '.' for empty cells, e.g.
+// "X.O/.X./..O". returns 1 on success, 0 if the position can't be read
+int loadPosition(const char *source, char board[MAX_SIZE][MAX_SIZE], int *size) {
+    char line[64];
     int i, j;
-    int count, emptyRow, emptyCol;
+    FILE *file = fopen(source, "r");
     
-    // check all rows for near-complete lines
-    for (i = 0; i < size; i++) {
-        count = 0;           // count player's marks in this row
-        emptyRow = -1;       // track location of empty cell
-        emptyCol = -1;
+    if (file == NULL) {
+        const char *p = source;
         
-        for (j = 0; j < size; j++) {
-            if (board[i][j] == player) {
-                count++;     // player has a mark here
-            } else if (board[i][j] == ' ') {
-                emptyRow = i;  // remember empty cell position
-                emptyCol = j;
-            }
+        // size is the number of rows in the string
+        *size = 1;
+        for (i = 0; source[i] != '\0'; i++) {
+            if (source[i] == '/') (*size)++;
         }
+        if (*size < 3 || *size > MAX_SIZE) return 0;
         
-        // if player has size-1 marks and one empty cell: winning move!
-        if (count == size - 1 && emptyRow != -1) {
-            *row = emptyRow;   // return winning position
-            *col = emptyCol;
-            return 1;          // found a winning opportunity
-        }
-    }
-    
-    // check all columns using same logic as rows
-    for (j = 0; j < size; j++) {
-        count = 0;           // reset counter for each column
-        emptyRow = -1;       // reset empty cell tracker
-        emptyCol = -1;
-        
-        for (i = 0; i < size; i++) {
-            if (board[i][j] == player) {
-                count++;     // player has a mark in this column
-            } else if (board[i][j] == ' ') {
-                emptyRow = i;  // track empty cell in this column
-                emptyCol = j;
+        for (i = 0; i < *size; i++) {
+            for (j = 0; j < *size; j++, p++) {
+                if (*p == 'X' || *p == 'x') {
+                    board[i][j] = 'X';
+                } else if (*p == 'O' || *p == 'o') {
+                    board[i][j] = 'O';
+                } else if (*p == '.' || *p == '-' || *p == ' ') {
+                    board[i][j] = ' ';
+                } else {
+                    return 0;            // short row or unknown character
+                }
             }
+            if (*p != '/' && *p != '\0') return 0;  // row too long
+            p++;
         }
-        
-        // if player has size-1 marks and one empty: winning move!
-        if (count == size - 1 && emptyRow != -1) {
-            *row = emptyRow;   // return the winning position
-            *col = emptyCol;
-            return 1;          // found a winning opportunity
-        }
-    }
-    
-    // check main diagonal (top-left to bottom-right)
-    count = 0;             // reset counter
-    emptyRow = -1;         // reset empty cell tracker
-    emptyCol = -1;
-    
-    for (i = 0; i < size; i++) {
-        if (board[i][i] == player) {
-            count++;       // player has mark on diagonal at (i,i)
-        } else if (board[i][i] == ' ') {
-            emptyRow = i;  // track empty cell on diagonal
-            emptyCol = i;
-        }
+        return 1;
     }
     
-    // check if diagonal has size-1 marks with one empty cell
-    if (count == size - 1 && emptyRow != -1) {
-        *row = emptyRow;   // return winning position
-        *col = emptyCol;
-        return 1;          // found a winning move
+    if (fscanf(file, "%d", size) != 1 || *size < 3 || *size > MAX_SIZE) {
+        fclose(file);
+        return 0;
     }
+    fgets(line, sizeof(line), file);     // rest of the size line
     
-    // check anti-diagonal (top-right to bottom-left)
-    count = 0;                    // reset counter
-    emptyRow = -1;                // reset empty cell tracker
-    emptyCol = -1;
-    
-    for (i = 0; i < size; i++) {
-        if (board[i][size - 1 - i] == player) {
-            count++;               // player has mark on anti-diagonal
-        } else if (board[i][size - 1 - i] == ' ') {
-            emptyRow = i;          // track empty cell on anti-diagonal
-            emptyCol = size - 1 - i;
+    for (i = 0; i < *size; i++) {
+        int length = 0;
+        if (fgets(line, sizeof(line), file) != NULL) {
+            length = (int)strcspn(line, "\r\n");  // rows may lose trailing spaces
+        }
+        for (j = 0; j < *size; j++) {
+            char c = (j < length) ? line[j] : ' ';
+            board[i][j] = (c == 'X' || c == 'O') ? c : ' ';
         }
     }
-    
-    // check if anti-diagonal has size-1 marks with one empty cell
-    if (count == size - 1 && emptyRow != -1) {
-        *row = emptyRow;           // return winning position
-        *col = emptyCol;
-        return 1;                  // found a winning move
-    }
-    
-    return 0;
+    fclose(file);
+    return 1;
 }
 
-// enhanced ai move with strategic decision-making
-void aiMove(char board[MAX_SIZE][MAX_SIZE], int size, char aiPlayer) {
-    int row, col;
-    char opponent = (aiPlayer == 'X') ? 'O' : 'X';
-    
-    // strategy 1: try to win immediately
-    if (canWin(board, size, aiPlayer, &row, &col)) {
-        board[row][col] = aiPlayer;                  // place winning move
-        printf("AI plays at row %d, column %d (Winning move!)\n", row, col);
-        return;                                      // move complete
-    }
-    
-    // strategy 2: block opponent's winning move
-    if (canWin(board, size, opponent, &row, &col)) {
-        board[row][col] = aiPlayer;                  // block the threat
-        printf("AI plays at row %d, column %d (Blocking move!)\n", row, col);
-        return;                                      // move complete
-    }
-    
-    // strategy 3: take center if available (strong position)
-    if (size % 2 == 1) {                               // only for odd-sized boards
-        int center = size / 2;                         // calculate center position
-        if (isCellEmpty(board, center, center)) {
-            board[center][center] = aiPlayer;          // place mark at center
-            printf("AI plays at row %d, column %d (Center move!)\n", center, center);
-            return;                                    // move complete
+// solve command: mainp2 solve [--mem MB] [savefile | board string]
+// proves the position a win, loss or draw for the side to move and
+// prints the proof size, search time and principal variation
+int solveCommand(int argc, char *argv[]) {
+    char board[MAX_SIZE][MAX_SIZE];
+    const char *source = "savegame.txt";
+    long memoryMb = 64;
+    int size, i, j;
+    int xCount = 0, oCount = 0;
+    char toMove;
+    SolveResult result;
+    clock_t start;
+    double seconds;
+    
+    // parse the optional memory limit and position source
+    for (i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--mem") == 0 && i + 1 < argc) {
+            char *end;
+            memoryMb = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || memoryMb < 1
+                || (unsigned long)memoryMb > SIZE_MAX / (1024 * 1024)) {
+                printf("Invalid memory limit \"%s\": give a whole number of MB, at least 1.\n", argv[i]);
+                return 1;
+            }
+        } else {
+            source = argv[i];
         }
     }
     
-    // strategy 4: take a corner (strategic positions)
-    int corners[4][2] = {{0, 0}, {0, size-1}, {size-1, 0}, {size-1, size-1}};
-    for (int i = 0; i < 4; i++) {
-        if (isCellEmpty(board, corners[i][0], corners[i][1])) {
-            board[corners[i][0]][corners[i][1]] = aiPlayer;  // place at corner
-            printf("AI plays at row %d, column %d (Corner move!)\n", corners[i][0], corners[i][1]);
-            return;                                    // move complete
-        }
+    if (!loadPosition(source, board, &size)) {
+        printf("Could not read a position from \"%s\".\n", source);
+        return 1;
     }
     
-    // strategy 5: pick random empty cell (fallback)
-    do {
-        row = rand() % size;      // generate random row
-        col = rand() % size;      // generate random column
-    } while (!isCellEmpty(board, row, col));  // repeat until empty cell found
-    
-    board[row][col] = aiPlayer;   // place mark at random position
-    printf("AI plays at row %d, column %d\n", row, col);
-}
-
-// check if a player has won
-int checkWin(char board[MAX_SIZE][MAX_SIZE], int size, char player) {
-    int i, j;
-    int win;
-    
-    // check all rows for complete win
+    // x always starts, so the mark counts tell us whose turn it is
     for (i = 0; i < size; i++) {
-        win = 1;                                // assume row is a win
         for (j = 0; j < size; j++) {
-            if (board[i][j] != player) {
-                win = 0;                       // found non-player mark
-                break;                         // stop checking this row
-            }
+            if (board[i][j] == 'X') xCount++;
+            if (board[i][j] == 'O') oCount++;
         }
-        if (win) return 1;                     // found winning row!
     }
-    
-    // check all columns for complete win
-    for (j = 0; j < size; j++) {
-        win = 1;                                // assume column is a win
-        for (i = 0; i < size; i++) {
-            if (board[i][j] != player) {
-                win = 0;                       // found non-player mark
-                break;                         // stop checking this column
-            }
-        }
-        if (win) return 1;                     // found winning column!
+    if (xCount == oCount) {
+        toMove = 'X';
+    } else if (xCount == oCount + 1) {
+        toMove = 'O';
+    } else {
+        printf("Illegal position: X has %d marks and O has %d.\n", xCount, oCount);
+        return 1;
     }
     
-    // check main diagonal (top-left to bottom-right)
-    win = 1;                                   // assume diagonal is a win
-    for (i = 0; i < size; i++) {
-        if (board[i][i] != player) {
-            win = 0;                           // found non-player mark
-            break;                             // stop checking
-        }
+    printBoard(board, size);
+    if (checkWin(board, size, 'X') || checkWin(board, size, 'O')) {
+        printf("Game is already over: Player %c has won.\n",
+               checkWin(board, size, 'X') ? 'X' : 'O');
+        return 0;
     }
-    if (win) return 1;                         // found winning diagonal!
-    
-    // check anti-diagonal (top-right to bottom-left)
-    win = 1;                                   // assume diagonal is a win
-    for (i = 0; i < size; i++) {
-        if (board[i][size - 1 - i] != player) {
-            win = 0;                           // found non-player mark
-            break;                             // stop checking
-        }
+    if (checkDraw(board, size)) {
+        printf("Game is already over: the board is full (draw).\n");
+        return 0;
     }
-    if (win) return 1;                         // found winning anti-diagonal!
     
-    return 0;                                  // no winning line found
-}
-
-// check if the game is a draw (board is full)
-int checkDraw(char board[MAX_SIZE][MAX_SIZE], int size) {
-    int i, j;
-    
-    // scan all cells for empty spaces
-    for (i = 0; i < size; i++) {
-        for (j = 0; j < size; j++) {
-            if (board[i][j] == ' ') {
-                return 0;  // found empty cell, game can continue
-            }
-        }
+    printf("Solving %dx%d position, %c to move (memory limit %ld MB)...\n",
+           size, size, toMove, memoryMb);
+    start = clock();
+    if (solvePosition(board, size, toMove, (size_t)memoryMb * 1024 * 1024, &result) != 0) {
+        printf("Memory limit too small or out of memory.\n");
+        return 1;
     }
-    
-    return 1;              // board is full, it's a draw
-}
-
-// update score based on game outcome
-void updateScore(char winner) {
-    if (winner == 'X') {
-        playerXScore++;  // increment player x's wins
-    } else if (winner == 'O') {
-        playerOScore++;  // increment player o's wins
-    } else if (winner == 'D') {
-        draws++;         // increment draw count
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    if (result.value == SOLVE_WIN) {
+        printf("Result: %c to move WINS\n", toMove);
+    } else if (result.value == SOLVE_LOSS) {
+        printf("Result: %c to move LOSES\n", toMove);
+    } else {
+        printf("Result: DRAW with best play\n");
+    }
+    printf("Proof size: %ld positions%s\n", result.proofSize,
+           result.proofSizeExact ? "" : " (lower bound, memory limit reached)");
+    printf("Nodes searched: %ld\n", result.nodes);
+    printf("Time: %.3f s\n", seconds);
+    
+    // principal variation as (row,col) pairs, alternating players
+    printf("Principal variation:");
+    for (i = 0; i < result.pvLength; i++) {
+        char player = (i % 2 == 0) ? toMove : (toMove == 'X' ? 'O' : 'X');
+        printf(" %c(%d,%d)", player, result.pv[i].row, result.pv[i].col);
     }
+    printf("\n");
+    return 0;
 }
@@ -0,0 +1,210 @@
+// position.c: 2-bit packing, base-3 ranking and symmetry reduction
+//
+// cell i (row * size + col) lives in bits 2*(i % 32) of words[i / 32].
+// ranking works a byte (four cells) at a time: a packed byte already
+// holds four base-3 digits, so it is turned into a value 0..80 and the
+// rank is built with one multiply by 81 per byte instead of one
+// multiply by 3 per cell.
+
+#include "position.h"
+
+// 2-bit code of a board character (branch-free: 1 for x, 2 for o)
+static uint64_t cellCode(char c) {
+    return (uint64_t)(c == 'X') | ((uint64_t)(c == 'O') << 1);
+}
+
+static char codeChar(uint64_t code) {
+    if (code == 1) return 'X';
+    if (code == 2) return 'O';
+    return ' ';
+}
+
+// pack a board array into 2 bits per cell
+void packBoard(char board[MAX_SIZE][MAX_SIZE], int size, PackedBoard *packed) {
+    int i, j, w;
+
+    for (w = 0; w < PACKED_WORDS; w++) {
+        packed->words[w] = 0;
+    }
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            int cell = i * size + j;
+            packed->words[cell >> 5] |= cellCode(board[i][j]) << ((cell & 31) * 2);
+        }
+    }
+}
+
+// unpack into a board array of ' ', 'X' and 'O'
+void unpackBoard(const PackedBoard *packed, int size, char board[MAX_SIZE][MAX_SIZE]) {
+    int i, j;
+
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            int cell = i * size + j;
+            board[i][j] = codeChar((packed->words[cell >> 5] >> ((cell & 31) * 2)) & 3);
+        }
+    }
+}
+
+// read a single cell without unpacking the whole board
+char packedGet(const PackedBoard *packed, int size, int row, int col) {
+    int cell = row * size + col;
+    return codeChar((packed->words[cell >> 5] >> ((cell & 31) * 2)) & 3);
+}
+
+// total order on packed boards: -1, 0 or 1 like strcmp
+int packedCompare(const PackedBoard *a, const PackedBoard *b) {
+    int w;
+
+    for (w = PACKED_WORDS - 1; w >= 0; w--) {
+        if (a->words[w] != b->words[w]) {
+            return (a->words[w] < b->words[w]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// 64-bit hash of a packed board for hash tables
+uint64_t packedHash(const PackedBoard *packed) {
+    uint64_t h = 0;
+    int w;
+
+    for (w = 0; w < PACKED_WORDS; w++) {
+        h = (h ^ packed->words[w]) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// number of distinct ranks for a size: 3^(size*size), or RANK_INVALID
+// outside 3..RANK_MAX_SIZE
+uint64_t rankCount(int size) {
+    uint64_t count = 1;
+    int i;
+
+    if (size < 3 || size > RANK_MAX_SIZE) {
+        return RANK_INVALID;
+    }
+    for (i = 0; i < size * size; i++) {
+        count *= 3;
+    }
+    return count;
+}
+
+// base-3 value (0..80) of the four 2-bit cell codes in one packed byte
+static uint64_t byteDigits(uint64_t byte) {
+    return (byte & 3) + 3 * ((byte >> 2) & 3) + 9 * ((byte >> 4) & 3) + 27 * (byte >> 6);
+}
+
+// dense rank of a packed board
+// returns RANK_INVALID if size is outside 3..RANK_MAX_SIZE
+uint64_t rankPacked(const PackedBoard *packed, int size) {
+    int bytes = (size * size + 3) / 4;  // four cells per byte
+    uint64_t rank = 0;
+    int b;
+
+    if (size < 3 || size > RANK_MAX_SIZE) {
+        return RANK_INVALID;
+    }
+
+    // horner's rule from the highest byte down; unused cells are zero
+    for (b = bytes - 1; b >= 0; b--) {
+        uint64_t byte = (packed->words[b >> 3] >> ((b & 7) * 8)) & 0xFF;
+        rank = rank * 81 + byteDigits(byte);
+    }
+    return rank;
+}
+
+// inverse of rankPacked; a size outside 3..RANK_MAX_SIZE gives an empty board
+void unrankPacked(uint64_t rank, int size, PackedBoard *packed) {
+    int cells = size * size;
+    int cell, w;
+
+    for (w = 0; w < PACKED_WORDS; w++) {
+        packed->words[w] = 0;
+    }
+    if (size < 3 || size > RANK_MAX_SIZE) {
+        return;
+    }
+    for (cell = 0; cell < cells; cell++) {
+        packed->words[cell >> 5] |= (rank % 3) << ((cell & 31) * 2);
+        rank /= 3;
+    }
+}
+
+uint64_t rankBoard(char board[MAX_SIZE][MAX_SIZE], int size) {
+    PackedBoard packed;
+    packBoard(board, size, &packed);
+    return rankPacked(&packed, size);
+}
+
+void unrankBoard(uint64_t rank, int size, char board[MAX_SIZE][MAX_SIZE]) {
+    PackedBoard packed;
+    unrankPacked(rank, size, &packed);
+    unpackBoard(&packed, size, board);
+}
+
+// where (row, col) goes under one of the 8 symmetries of the square:
+// 0 identity, 1-3 rotations by 90/180/270 degrees, 4 mirror left-right,
+// 5 transpose, 6 mirror top-bottom, 7 anti-transpose
+void transformCell(int size, int symmetry, int row, int col, int *outRow, int *outCol) {
+    int last = size - 1;
+
+    switch (symmetry) {
+        case 1:  *outRow = col;        *outCol = last - row; break;
+        case 2:  *outRow = last - row; *outCol = last - col; break;
+        case 3:  *outRow = last - col; *outCol = row;        break;
+        case 4:  *outRow = row;        *outCol = last - col; break;
+        case 5:  *outRow = col;        *outCol = row;        break;
+        case 6:  *outRow = last - row; *outCol = col;        break;
+        case 7:  *outRow = last - col; *outCol = last - row; break;
+        default: *outRow = row;        *outCol = col;        break;
+    }
+}
+
+// smallest (packedCompare) of the 8 symmetric images of a board
+// all 8 images are built in one pass over the occupied cells
+// returns the symmetry that maps the board onto the canonical one
+int canonicalPacked(const PackedBoard *packed, int size, PackedBoard *canonical) {
+    PackedBoard images[SYMMETRIES];
+    int best = 0;
+    int row, col, t, w;
+
+    for (t = 0; t < SYMMETRIES; t++) {
+        for (w = 0; w < PACKED_WORDS; w++) {
+            images[t].words[w] = 0;
+        }
+    }
+    for (row = 0; row < size; row++) {
+        for (col = 0; col < size; col++) {
+            int cell = row * size + col;
+            uint64_t code = (packed->words[cell >> 5] >> ((cell & 31) * 2)) & 3;
+            if (code == 0) {
+                continue;  // empty cells are zero in every image
+            }
+            for (t = 0; t < SYMMETRIES; t++) {
+                int r, c, target;
+                transformCell(size, t, row, col, &r, &c);
+                target = r * size + c;
+                images[t].words[target >> 5] |= code << ((target & 31) * 2);
+            }
+        }
+    }
+
+    for (t = 1; t < SYMMETRIES; t++) {
+        if (packedCompare(&images[t], &images[best]) < 0) {
+            best = t;
+        }
+    }
+    *canonical = images[best];
+    return best;
+}
+
+// rank of the canonical image: equal for all symmetric positions
+// (RANK_INVALID for sizes above RANK_MAX_SIZE, like rankPacked)
+uint64_t canonicalRank(char board[MAX_SIZE][MAX_SIZE], int size) {
+    PackedBoard packed, canonical;
+    packBoard(board, size, &packed);
+    canonicalPacked(&packed, size, &canonical);
+    return rankPacked(&canonical, size);
+}
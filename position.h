@@ -0,0 +1,59 @@
+// position.h: compact position encodings for storing and indexing boards
+//
+// a board in memory is a 100-byte char[MAX_SIZE][MAX_SIZE] array. for
+// position archives and hash keys there are two smaller forms:
+// - PackedBoard: 2 bits per cell (00 empty, 01 x, 10 o) in four 64-bit
+//   words, 32 bytes for any size. boards up to 5x5 fit in words[0] alone,
+//   so an 8-byte key is enough for them.
+// - rank: the position read as a base-3 number (cell 0 is the lowest
+//   digit), a dense integer in 0 .. 3^(size*size)-1. it fits in a uint64_t
+//   up to 6x6; a 3x3 rank fits in 2 bytes and a 4x4 rank in 4.
+// canonicalPacked picks one representative of the 8 rotations and
+// reflections of a board, so symmetric positions share one key.
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <stdint.h>
+
+#include "threats.h"
+
+#define PACKED_WORDS   4  // 64-bit words in a PackedBoard (2 bits x 100 cells)
+#define RANK_MAX_SIZE  6  // largest board whose rank fits in 64 bits
+#define SYMMETRIES     8  // rotations and reflections of a square board
+#define RANK_INVALID   UINT64_MAX  // rank of a size outside 3..RANK_MAX_SIZE (never a real rank)
+
+typedef struct {
+    uint64_t words[PACKED_WORDS];
+} PackedBoard;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// board array <-> packed form
+void packBoard(char board[MAX_SIZE][MAX_SIZE], int size, PackedBoard *packed);
+void unpackBoard(const PackedBoard *packed, int size, char board[MAX_SIZE][MAX_SIZE]);
+char packedGet(const PackedBoard *packed, int size, int row, int col);
+int packedCompare(const PackedBoard *a, const PackedBoard *b);
+uint64_t packedHash(const PackedBoard *packed);
+
+// dense base-3 ranks, size 3..RANK_MAX_SIZE only: larger ranks would
+// overflow 64 bits, so other sizes get RANK_INVALID (and an empty board
+// from the unrank calls)
+uint64_t rankCount(int size);
+uint64_t rankPacked(const PackedBoard *packed, int size);
+void unrankPacked(uint64_t rank, int size, PackedBoard *packed);
+uint64_t rankBoard(char board[MAX_SIZE][MAX_SIZE], int size);
+void unrankBoard(uint64_t rank, int size, char board[MAX_SIZE][MAX_SIZE]);
+
+// symmetry
+void transformCell(int size, int symmetry, int row, int col, int *outRow, int *outCol);
+int canonicalPacked(const PackedBoard *packed, int size, PackedBoard *canonical);
+uint64_t canonicalRank(char board[MAX_SIZE][MAX_SIZE], int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
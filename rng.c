@@ -0,0 +1,90 @@
+// rng.c: xoshiro256** streams, splitmix64 seeding and bounded draws
+
+#include "rng.h"
+
+static uint64_t rotateLeft(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// splitmix64: one well-mixed number per call; also used to seed Rng
+uint64_t splitMix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// fill the state from a 64-bit seed (never all zero: splitmix64 output
+// for four consecutive steps can't all be zero)
+void rngSeed(Rng *rng, uint64_t seed) {
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        rng->s[i] = splitMix64(&seed);
+    }
+}
+
+// stream `stream` of seed: the pair is hashed into a fresh 64-bit seed,
+// so neighbouring streams start from unrelated states
+void rngSeedStream(Rng *rng, uint64_t seed, uint64_t stream) {
+    uint64_t mixed = stream ^ 0x6A09E667F3BCC909ULL;
+
+    rngSeed(rng, splitMix64(&seed) ^ splitMix64(&mixed));
+}
+
+// next 64 random bits
+uint64_t rngNext(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft(s[3], 45);
+    return result;
+}
+
+// advance by 2^128 calls of rngNext
+void rngJump(Rng *rng) {
+    static const uint64_t jump[4] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    uint64_t s[4] = {0, 0, 0, 0};
+    int i, b, w;
+
+    for (i = 0; i < 4; i++) {
+        for (b = 0; b < 64; b++) {
+            if (jump[i] & (1ULL << b)) {
+                for (w = 0; w < 4; w++) {
+                    s[w] ^= rng->s[w];
+                }
+            }
+            rngNext(rng);
+        }
+    }
+    for (w = 0; w < 4; w++) {
+        rng->s[w] = s[w];
+    }
+}
+
+// uniform in 0..bound-1 (bound >= 1) by lemire's multiply-and-shift:
+// the high half of random * bound is the result, and the rare low
+// halves that would make some results more likely are redrawn
+int rngBelow(Rng *rng, int bound) {
+    uint32_t range = (uint32_t)bound;
+    uint64_t product = (rngNext(rng) >> 32) * range;
+    uint32_t low = (uint32_t)product;
+
+    if (low < range) {
+        uint32_t threshold = -range % range;  // 2^32 mod range
+        while (low < threshold) {
+            product = (rngNext(rng) >> 32) * range;
+            low = (uint32_t)product;
+        }
+    }
+    return (int)(product >> 32);
+}
@@ -0,0 +1,40 @@
+// rng.h: seeded random number streams for the ai and the simulators
+//
+// Rng is xoshiro256** (four 64-bit words of state, a handful of shifts
+// and xors per number). every stream is seeded explicitly, so a run can
+// be replayed from its seed, and each game or thread owns its own Rng,
+// so nothing is shared between threads.
+// - rngSeed expands one 64-bit seed into a full state with splitmix64.
+// - rngSeedStream derives stream number `stream` of a seed, e.g. one per
+//   game: game i gets the same numbers however the games are spread over
+//   threads.
+// - rngJump advances a stream by 2^128 numbers, for splitting one seed
+//   into long non-overlapping sequences.
+// - rngBelow draws from 0..bound-1 without the bias of rand() % bound.
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+uint64_t splitMix64(uint64_t *state);
+
+void rngSeed(Rng *rng, uint64_t seed);
+void rngSeedStream(Rng *rng, uint64_t seed, uint64_t stream);
+uint64_t rngNext(Rng *rng);
+void rngJump(Rng *rng);
+int rngBelow(Rng *rng, int bound);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,360 @@
+// simulate.c: batch ai-vs-ai simulations with win heatmaps
+//
+// plays many games for every combination of board size and ai pairing,
+// spread over several threads, and reports where and when the games were
+// won. each thread plays its share of the games in batches through the
+// engine's batch calls and records them in its own heatmaps; the
+// heatmaps are only merged after every thread has finished, so the
+// simulation loop never waits on another thread.
+//
+// game i of job j always plays with random stream (j << 32) + i of the
+// run's seed, so the same --seed gives the same heatmaps whatever the
+// number of threads.
+//
+// "hard" plays the alpha-beta search with the default evaluation weights;
+// its line-score table is built once per board size and shared read-only
+// by every thread.
+//
+// usage: ./simulate [--games N] [--threads T] [--sizes 3,4,5]
+//                   [--pairings easy:medium,medium:hard] [--seed N]
+//                   [--csv heatmap.csv] [--json heatmap.json]
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "analytics.h"
+#include "engine.h"
+#include "eval.h"
+
+#define MAX_JOBS    64  // size x pairing combinations per run
+#define MAX_THREADS 64
+#define BATCH_SIZE  64  // games advanced together by one batch call
+
+// one board size and ai pairing
+typedef struct {
+    int size;
+    int xLevel;
+    int oLevel;
+    const EvalTable *table;  // line scores for AI_HARD (NULL if neither side is hard)
+} Job;
+
+// one simulation thread: plays games [firstGame, lastGame) of every job
+typedef struct {
+    const Job *jobs;
+    int jobCount;
+    uint64_t seed;  // seed of the whole run
+    long firstGame;
+    long lastGame;
+    Heatmap *maps;  // this thread's heatmap for each job
+    pthread_t thread;
+} Worker;
+
+static const char *levelName(int level) {
+    return (level == AI_EASY) ? "easy" : (level == AI_MEDIUM) ? "medium" : "hard";
+}
+
+// "easy", "medium" or "hard"; returns 0 for anything else
+static int parseLevel(const char *text, int length) {
+    if (length == 4 && strncmp(text, "easy", 4) == 0) return AI_EASY;
+    if (length == 6 && strncmp(text, "medium", 6) == 0) return AI_MEDIUM;
+    if (length == 4 && strncmp(text, "hard", 4) == 0) return AI_HARD;
+    return 0;
+}
+
+// play count fresh games to the end; every game is at the same ply, so
+// one batch call per ply moves x (even plies) or o (odd plies) everywhere
+// games[i] uses random stream firstStream + i of seed
+static void playBatch(Game games[], int count, const Job *job, uint64_t seed, uint64_t firstStream) {
+    int ply = 0, running = count, i;
+
+    for (i = 0; i < count; i++) {
+        gameInit(&games[i], job->size);
+        gameSeed(&games[i], seed, firstStream + i);
+    }
+    while (running > 0) {
+        running = gamePlayAiMoves(games, count, (ply % 2 == 0) ? job->xLevel : job->oLevel, job->table);
+        ply++;
+    }
+}
+
+static void *runWorker(void *arg) {
+    Worker *worker = arg;
+    Game games[BATCH_SIZE];
+    int j, i;
+
+    for (j = 0; j < worker->jobCount; j++) {
+        const Job *job = &worker->jobs[j];
+        long game;
+
+        heatmapInit(&worker->maps[j], job->size, job->xLevel, job->oLevel);
+        for (game = worker->firstGame; game < worker->lastGame; game += BATCH_SIZE) {
+            int count = (worker->lastGame - game < BATCH_SIZE)
+                        ? (int)(worker->lastGame - game) : BATCH_SIZE;
+            playBatch(games, count, job, worker->seed, ((uint64_t)j << 32) + (uint64_t)game);
+            for (i = 0; i < count; i++) {
+                heatmapRecord(&worker->maps[j], &games[i]);
+            }
+        }
+    }
+    return NULL;
+}
+
+// long-format csv: one row per counter, easy to pivot into heatmaps
+// metric is cell (row/col set), row/col/diag/anti (index = line number)
+// or ply (index = moves played when the game was won)
+static void writeCsv(FILE *out, const Heatmap maps[], int count) {
+    int m, p, i;
+
+    fprintf(out, "size,x_ai,o_ai,winner,metric,index,row,col,count\n");
+    for (m = 0; m < count; m++) {
+        const Heatmap *map = &maps[m];
+        int size = map->size;
+        const char *x = levelName(map->xLevel), *o = levelName(map->oLevel);
+
+        for (p = 0; p < 2; p++) {
+            char winner = (p == 0) ? 'X' : 'O';
+            for (i = 0; i < size * size; i++) {
+                fprintf(out, "%d,%s,%s,%c,cell,%d,%d,%d,%ld\n",
+                        size, x, o, winner, i, i / size, i % size, map->cellWins[p][i]);
+            }
+            for (i = 0; i < size; i++) {
+                fprintf(out, "%d,%s,%s,%c,row,%d,,,%ld\n", size, x, o, winner, i, map->lineWins[p][i]);
+            }
+            for (i = 0; i < size; i++) {
+                fprintf(out, "%d,%s,%s,%c,col,%d,,,%ld\n", size, x, o, winner, i, map->lineWins[p][size + i]);
+            }
+            fprintf(out, "%d,%s,%s,%c,diag,0,,,%ld\n", size, x, o, winner, map->lineWins[p][2 * size]);
+            fprintf(out, "%d,%s,%s,%c,anti,0,,,%ld\n", size, x, o, winner, map->lineWins[p][2 * size + 1]);
+            for (i = 1; i <= size * size; i++) {
+                fprintf(out, "%d,%s,%s,%c,ply,%d,,,%ld\n", size, x, o, winner, i, map->plyWins[p][i]);
+            }
+        }
+    }
+}
+
+static void writeJsonArray(FILE *out, const long values[], int count) {
+    int i;
+
+    fprintf(out, "[");
+    for (i = 0; i < count; i++) {
+        fprintf(out, (i == 0) ? "%ld" : ", %ld", values[i]);
+    }
+    fprintf(out, "]");
+}
+
+// one object per size/pairing; cells are a size x size grid per winner
+static void writeJson(FILE *out, const Heatmap maps[], int count) {
+    int m, p, r;
+
+    fprintf(out, "[\n");
+    for (m = 0; m < count; m++) {
+        const Heatmap *map = &maps[m];
+        int size = map->size;
+
+        fprintf(out, "  {\"size\": %d, \"x_ai\": \"%s\", \"o_ai\": \"%s\", \"games\": %ld,"
+                " \"x_wins\": %ld, \"o_wins\": %ld, \"draws\": %ld,\n",
+                size, levelName(map->xLevel), levelName(map->oLevel),
+                map->games, map->xWins, map->oWins, map->draws);
+        for (p = 0; p < 2; p++) {
+            fprintf(out, "   \"%c\": {\"cells\": [", (p == 0) ? 'X' : 'O');
+            for (r = 0; r < size; r++) {
+                if (r > 0) fprintf(out, ", ");
+                writeJsonArray(out, &map->cellWins[p][r * size], size);
+            }
+            fprintf(out, "],\n         \"rows\": ");
+            writeJsonArray(out, &map->lineWins[p][0], size);
+            fprintf(out, ", \"cols\": ");
+            writeJsonArray(out, &map->lineWins[p][size], size);
+            fprintf(out, ", \"diag\": %ld, \"anti\": %ld,\n         \"plies\": ",
+                    map->lineWins[p][2 * size], map->lineWins[p][2 * size + 1]);
+            writeJsonArray(out, &map->plyWins[p][0], size * size + 1);
+            fprintf(out, "}%s\n", (p == 0) ? "," : "");
+        }
+        fprintf(out, "  }%s\n", (m + 1 < count) ? "," : "");
+    }
+    fprintf(out, "]\n");
+}
+
+int main(int argc, char *argv[]) {
+    Job jobs[MAX_JOBS];
+    Worker workers[MAX_THREADS];
+    Heatmap *totals;
+    EvalTable tables[MAX_SIZE + 1];  // default-weight tables of the sizes a hard ai plays
+    int tableBuilt[MAX_SIZE + 1] = {0};
+    int sizes[MAX_SIZE + 1], sizeCount = 0;
+    int pairings[MAX_JOBS][2], pairingCount = 0;
+    const char *sizeList = "3,4,5";
+    const char *pairingList = "easy:easy,medium:medium";
+    const char *csvFile = NULL, *jsonFile = NULL;
+    long gamesPerJob = 100000;
+    int threads = 4;
+    int jobCount = 0;
+    uint64_t seed = (uint64_t)time(NULL);
+    struct timespec start, end;
+    double seconds;
+    int i, j, t;
+    const char *p;
+
+    for (i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            printf("Missing value for %s\n", argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--games") == 0) gamesPerJob = atol(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--sizes") == 0) sizeList = argv[++i];
+        else if (strcmp(argv[i], "--pairings") == 0) pairingList = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0) csvFile = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0) jsonFile = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[++i], NULL, 10);
+        else {
+            printf("Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (threads < 1 || threads > MAX_THREADS || gamesPerJob < 1) {
+        printf("Need 1-%d threads and at least one game.\n", MAX_THREADS);
+        return 1;
+    }
+
+    // comma-separated sizes
+    for (p = sizeList; *p != '\0'; ) {
+        int size = (int)strtol(p, (char **)&p, 10);
+        if (sizeCount == MAX_SIZE + 1) {
+            printf("At most %d board sizes per run.\n", MAX_SIZE + 1);
+            return 1;
+        }
+        if (size < 3 || size > MAX_SIZE) {
+            printf("Board sizes must be between 3 and %d.\n", MAX_SIZE);
+            return 1;
+        }
+        sizes[sizeCount++] = size;
+        if (*p == ',') p++;
+        else if (*p != '\0') { printf("Bad size list %s\n", sizeList); return 1; }
+    }
+
+    // comma-separated x:o pairings
+    for (p = pairingList; *p != '\0'; ) {
+        const char *colon = strchr(p, ':');
+        const char *end;
+        if (pairingCount == MAX_JOBS) {
+            printf("At most %d pairings per run.\n", MAX_JOBS);
+            return 1;
+        }
+        if (colon == NULL) { printf("Bad pairing list %s\n", pairingList); return 1; }
+        end = colon + strcspn(colon, ",");
+        pairings[pairingCount][0] = parseLevel(p, (int)(colon - p));
+        pairings[pairingCount][1] = parseLevel(colon + 1, (int)(end - colon - 1));
+        if (pairings[pairingCount][0] == 0 || pairings[pairingCount][1] == 0) {
+            printf("AI levels are easy, medium or hard.\n");
+            return 1;
+        }
+        pairingCount++;
+        p = (*end == ',') ? end + 1 : end;
+    }
+
+    if (sizeCount * pairingCount > MAX_JOBS) {
+        printf("%d sizes x %d pairings is more than %d combinations per run.\n",
+               sizeCount, pairingCount, MAX_JOBS);
+        return 1;
+    }
+    for (i = 0; i < sizeCount; i++) {
+        for (j = 0; j < pairingCount; j++) {
+            jobs[jobCount].size = sizes[i];
+            jobs[jobCount].xLevel = pairings[j][0];
+            jobs[jobCount].oLevel = pairings[j][1];
+            jobs[jobCount].table = NULL;
+            if (pairings[j][0] == AI_HARD || pairings[j][1] == AI_HARD) {
+                if (!tableBuilt[sizes[i]]) {
+                    if (evalTableInit(&tables[sizes[i]], sizes[i], NULL) != 0) {
+                        printf("Out of memory.\n");
+                        return 1;
+                    }
+                    tableBuilt[sizes[i]] = 1;
+                }
+                jobs[jobCount].table = &tables[sizes[i]];
+            }
+            jobCount++;
+        }
+    }
+
+    totals = malloc(jobCount * sizeof(Heatmap));
+    for (t = 0; t < threads; t++) {
+        workers[t].maps = malloc(jobCount * sizeof(Heatmap));
+        if (workers[t].maps == NULL || totals == NULL) {
+            printf("Out of memory.\n");
+            return 1;
+        }
+    }
+
+    printf("Simulating %ld games for each of %d size/pairing combinations on %d threads (seed %llu)...\n",
+           gamesPerJob, jobCount, threads, (unsigned long long)seed);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (t = 0; t < threads; t++) {
+        workers[t].jobs = jobs;
+        workers[t].jobCount = jobCount;
+        workers[t].seed = seed;
+        workers[t].firstGame = gamesPerJob * t / threads;
+        workers[t].lastGame = gamesPerJob * (t + 1) / threads;
+        pthread_create(&workers[t].thread, NULL, runWorker, &workers[t]);
+    }
+    for (t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    // merge the per-thread heatmaps now that nobody is writing to them
+    for (j = 0; j < jobCount; j++) {
+        heatmapInit(&totals[j], jobs[j].size, jobs[j].xLevel, jobs[j].oLevel);
+        for (t = 0; t < threads; t++) {
+            heatmapMerge(&totals[j], &workers[t].maps[j]);
+        }
+    }
+
+    printf("\nsize  x ai    o ai    x wins    o wins    draws\n");
+    for (j = 0; j < jobCount; j++) {
+        printf("%2dx%-2d %-7s %-7s %8ld  %8ld  %8ld\n", totals[j].size, totals[j].size,
+               levelName(totals[j].xLevel), levelName(totals[j].oLevel),
+               totals[j].xWins, totals[j].oWins, totals[j].draws);
+    }
+    printf("\n%ld games in %.2f s (%.0f games/s)\n",
+           gamesPerJob * jobCount, seconds, gamesPerJob * jobCount / seconds);
+
+    if (csvFile != NULL) {
+        FILE *out = fopen(csvFile, "w");
+        if (out == NULL) {
+            printf("Could not write %s\n", csvFile);
+        } else {
+            writeCsv(out, totals, jobCount);
+            fclose(out);
+            printf("Heatmaps written to %s\n", csvFile);
+        }
+    }
+    if (jsonFile != NULL) {
+        FILE *out = fopen(jsonFile, "w");
+        if (out == NULL) {
+            printf("Could not write %s\n", jsonFile);
+        } else {
+            writeJson(out, totals, jobCount);
+            fclose(out);
+            printf("Heatmaps written to %s\n", jsonFile);
+        }
+    }
+
+    for (t = 0; t < threads; t++) {
+        free(workers[t].maps);
+    }
+    free(totals);
+    for (i = 0; i <= MAX_SIZE; i++) {
+        if (tableBuilt[i]) {
+            evalTableFree(&tables[i]);
+        }
+    }
+    return 0;
+}
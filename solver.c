@@ -0,0 +1,516 @@
+// solver.c: depth-first proof-number search for tic-tac-toe positions
+//
+// every search has an attacker. at OR nodes the attacker is to move and
+// one winning child is enough; at AND nodes the defender is to move and
+// every child has to be a win for the attacker. each node carries a
+// proof number (pn: how many leaves still need proving) and a disproof
+// number (dn: how many need disproving). df-pn always descends into the
+// most-proving child and only returns when the child's numbers cross
+// the thresholds handed down by its parent, so the tree is never held in
+// memory - only the transposition table is.
+//
+// a draw counts as a failure for the attacker, so a position is a draw
+// exactly when neither player can be proven to win. moves only ever add
+// marks, so the game graph has no cycles and plain df-pn is sound.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "rng.h"
+#include "solver.h"
+
+#define PN_INF 100000000u // proof/disproof number of a decided node
+
+// one transposition table slot; always-replace keeps memory fixed
+typedef struct {
+    uint64_t key;
+    uint32_t pn;
+    uint32_t dn;
+} TTEntry;
+
+typedef struct {
+    char board[MAX_SIZE][MAX_SIZE];
+    int size;
+    int empties;                     // empty cells left on the board
+    char attacker;                   // player the current search tries to prove a win for
+    uint64_t hash;                   // zobrist hash of the marks on the board
+    uint64_t zobrist[MAX_CELLS][2];  // random key per cell and player
+    uint64_t attackerKey[2];         // mixed in so both searches share one table
+    TTEntry *table;
+    size_t tableMask;
+    uint64_t *visited;               // positions already counted in the proof tree
+    size_t visitedMask;
+    size_t visitedCount;
+    int visitedFull;
+    long nodes;
+    long proofSize;
+} Solver;
+
+static char otherPlayer(char player) {
+    return (player == 'X') ? 'O' : 'X';
+}
+
+// largest power of two number of items of itemSize that fit in bytes
+static size_t powerOfTwoFit(size_t bytes, size_t itemSize) {
+    size_t count = 1;
+    // compare against bytes / (2 * itemSize) so count * 2 * itemSize can't overflow
+    while (count <= bytes / (2 * itemSize)) {
+        count *= 2;
+    }
+    return (count * itemSize <= bytes) ? count : 0;
+}
+
+// key of the current position for the current search
+static uint64_t positionKey(const Solver *s) {
+    return s->hash ^ s->attackerKey[playerIndex(s->attacker)];
+}
+
+// key of the position reached by playing cell for player
+static uint64_t childKey(const Solver *s, Cell cell, char player) {
+    return positionKey(s) ^ s->zobrist[cell.row * s->size + cell.col][playerIndex(player)];
+}
+
+static int lookup(const Solver *s, uint64_t key, uint32_t *pn, uint32_t *dn) {
+    const TTEntry *entry = &s->table[key & s->tableMask];
+    if (entry->key != key) {
+        return 0;
+    }
+    *pn = entry->pn;
+    *dn = entry->dn;
+    return 1;
+}
+
+static void store(Solver *s, uint64_t key, uint32_t pn, uint32_t dn) {
+    TTEntry *entry = &s->table[key & s->tableMask];
+    entry->key = key;
+    entry->pn = pn;
+    entry->dn = dn;
+}
+
+static void play(Solver *s, Cell cell, char player) {
+    s->board[cell.row][cell.col] = player;
+    s->hash ^= s->zobrist[cell.row * s->size + cell.col][playerIndex(player)];
+    s->empties--;
+}
+
+static void undo(Solver *s, Cell cell, char player) {
+    s->board[cell.row][cell.col] = ' ';
+    s->hash ^= s->zobrist[cell.row * s->size + cell.col][playerIndex(player)];
+    s->empties++;
+}
+
+// proof/disproof numbers of a node whose outcome is already known
+static void decided(const Solver *s, char winner, uint32_t *pn, uint32_t *dn) {
+    if (winner == s->attacker) {
+        *pn = 0;
+        *dn = PN_INF;
+    } else {
+        *pn = PN_INF;  // loss or draw: the attacker failed
+        *dn = 0;
+    }
+}
+
+// does the attacker still have a line with none of the defender's marks?
+// once every line is blocked the attacker can't win, whatever is played
+static int attackerHasOpenLine(const Solver *s) {
+    char defender = otherPlayer(s->attacker);
+    int size = s->size;
+    int i, j, rowOpen, colOpen, diagOpen = 1, antiOpen = 1;
+
+    for (i = 0; i < size; i++) {
+        rowOpen = colOpen = 1;
+        for (j = 0; j < size && (rowOpen || colOpen); j++) {
+            if (s->board[i][j] == defender) rowOpen = 0;
+            if (s->board[j][i] == defender) colOpen = 0;
+        }
+        if (rowOpen || colOpen) return 1;
+        if (s->board[i][i] == defender) diagOpen = 0;
+        if (s->board[i][size - 1 - i] == defender) antiOpen = 0;
+    }
+    return diagOpen || antiOpen;
+}
+
+// generate the moves worth searching from the current position
+// threat analysis prunes the tree: a player with a win takes it, a
+// player facing one threat must block it, and facing two has lost.
+// positions where every line is blocked for the attacker are disproven
+// straight away, which is what makes drawn 5x5 positions tractable.
+// fills moves[] and marks children that end the game in a draw
+// (full board). returns the number of moves, or 0 when the node is
+// decided by itself, with its numbers written to *pn and *dn
+static int expand(Solver *s, char toMove, Cell moves[MAX_CELLS], int drawn[MAX_CELLS],
+                  uint32_t *pn, uint32_t *dn) {
+    ThreatInfo info;
+    int me = playerIndex(toMove);
+    int them = 1 - me;
+    int n, i;
+
+    analyzeThreats(s->board, s->size, &info);
+    if (info.winCount[me] > 0) {
+        decided(s, toMove, pn, dn);                // win on the spot
+        return 0;
+    }
+    if (s->empties == 0 || !attackerHasOpenLine(s)) {
+        decided(s, 'D', pn, dn);                   // board full or dead: draw
+        return 0;
+    }
+    if (info.winCount[them] > 1) {
+        decided(s, otherPlayer(toMove), pn, dn);   // can't block two threats
+        return 0;
+    }
+    if (info.winCount[them] == 1) {
+        moves[0] = info.wins[them][0];             // forced block
+        n = 1;
+    } else {
+        n = orderMoves(s->board, s->size, toMove, &info, moves);
+    }
+
+    // with no win available, the move that fills the board is a draw
+    for (i = 0; i < n; i++) {
+        drawn[i] = (s->empties == 1);
+    }
+    return n;
+}
+
+// sum of proof numbers, saturating below PN_INF unless a term is PN_INF
+static uint32_t addNumbers(uint32_t a, uint32_t b) {
+    if (a >= PN_INF || b >= PN_INF) {
+        return PN_INF;
+    }
+    return (a + b >= PN_INF) ? PN_INF - 1 : a + b;
+}
+
+// threshold for the best child given the second-best child's number
+// plain df-pn uses second + 1, which makes the search flip between two
+// close siblings over and over; letting the best child run until it is
+// 25% worse than its sibling (the "1 + epsilon" trick) avoids that
+static uint32_t growThreshold(uint32_t second) {
+    if (second >= PN_INF) {
+        return PN_INF;
+    }
+    return second + second / 4 + 1;
+}
+
+// multiple iterative deepening: search the current node until its
+// numbers reach thPn or thDn, then store them and return them
+static void mid(Solver *s, char toMove, uint32_t thPn, uint32_t thDn,
+                uint32_t *outPn, uint32_t *outDn) {
+    Cell moves[MAX_CELLS];
+    int drawn[MAX_CELLS];
+    uint32_t childPn[MAX_CELLS];
+    uint32_t childDn[MAX_CELLS];
+    uint32_t pn, dn;
+    int isOr = (toMove == s->attacker);
+    int n, i;
+
+    s->nodes++;
+    n = expand(s, toMove, moves, drawn, &pn, &dn);
+
+    while (n > 0) {
+        uint32_t best = PN_INF + 1, second = PN_INF + 1;
+        int bestIndex = 0;
+
+        // refresh children from the table; unseen children start at 1/1
+        for (i = 0; i < n; i++) {
+            if (drawn[i]) {
+                decided(s, 'D', &childPn[i], &childDn[i]);
+            } else if (!lookup(s, childKey(s, moves[i], toMove), &childPn[i], &childDn[i])) {
+                childPn[i] = 1;
+                childDn[i] = 1;
+            }
+        }
+
+        // OR node: pn = min child pn, dn = sum child dn (AND is the mirror)
+        pn = isOr ? PN_INF : 0;
+        dn = isOr ? 0 : PN_INF;
+        for (i = 0; i < n; i++) {
+            uint32_t key = isOr ? childPn[i] : childDn[i];
+            if (isOr) {
+                if (childPn[i] < pn) pn = childPn[i];
+                dn = addNumbers(dn, childDn[i]);
+            } else {
+                pn = addNumbers(pn, childPn[i]);
+                if (childDn[i] < dn) dn = childDn[i];
+            }
+            if (key < best) {
+                second = best;
+                best = key;
+                bestIndex = i;
+            } else if (key < second) {
+                second = key;
+            }
+        }
+        if (pn >= thPn || dn >= thDn) {
+            break;
+        }
+
+        // descend into the most-proving child with tightened thresholds
+        play(s, moves[bestIndex], toMove);
+        if (isOr) {
+            uint32_t childThPn = (growThreshold(second) < thPn) ? growThreshold(second) : thPn;
+            mid(s, otherPlayer(toMove), childThPn, thDn - dn + childDn[bestIndex],
+                &childPn[bestIndex], &childDn[bestIndex]);
+        } else {
+            uint32_t childThDn = (growThreshold(second) < thDn) ? growThreshold(second) : thDn;
+            mid(s, otherPlayer(toMove), thPn - pn + childPn[bestIndex], childThDn,
+                &childPn[bestIndex], &childDn[bestIndex]);
+        }
+        undo(s, moves[bestIndex], toMove);
+    }
+
+    store(s, positionKey(s), pn, dn);
+    *outPn = pn;
+    *outDn = dn;
+}
+
+// prove or disprove the current position for the current attacker
+// returns 1 if the attacker wins, 0 otherwise
+static int prove(Solver *s, char toMove) {
+    uint32_t pn, dn;
+    if (!lookup(s, positionKey(s), &pn, &dn) || (pn != 0 && dn != 0)) {
+        mid(s, toMove, PN_INF, PN_INF, &pn, &dn);
+    }
+    return pn == 0;
+}
+
+// is the position after cell a win for the attacker?
+// re-solves the child if the table entry was overwritten
+static int childProven(Solver *s, Cell cell, char toMove) {
+    int proven;
+    play(s, cell, toMove);
+    proven = prove(s, otherPlayer(toMove));
+    undo(s, cell, toMove);
+    return proven;
+}
+
+// remember a position as part of the proof tree; returns 0 if it was
+// already counted (or the set is full and counting has stopped)
+static int markVisited(Solver *s, uint64_t key) {
+    size_t slot;
+    if (key == 0) {
+        key = 1;  // 0 marks an empty slot
+    }
+    if (s->visitedFull) {
+        return 0;
+    }
+    if (s->visitedCount * 4 >= (s->visitedMask + 1) * 3) {
+        s->visitedFull = 1;
+        return 0;
+    }
+    for (slot = key & s->visitedMask; s->visited[slot] != 0; slot = (slot + 1) & s->visitedMask) {
+        if (s->visited[slot] == key) {
+            return 0;
+        }
+    }
+    s->visited[slot] = key;
+    s->visitedCount++;
+    s->proofSize++;
+    return 1;
+}
+
+// count the distinct positions of the proof (proven = 1) or disproof
+// tree below the current position. a proof needs one winning move at
+// OR nodes and every move at AND nodes; a disproof is the mirror image
+static void countProof(Solver *s, char toMove, int proven) {
+    Cell moves[MAX_CELLS];
+    int drawn[MAX_CELLS];
+    uint32_t pn, dn;
+    int needAll = (toMove == s->attacker) ? !proven : proven;
+    int n, i;
+
+    if (!markVisited(s, positionKey(s))) {
+        return;
+    }
+    n = expand(s, toMove, moves, drawn, &pn, &dn);
+    for (i = 0; i < n; i++) {
+        int childWins;
+        if (drawn[i]) {
+            childWins = 0;
+            if (needAll || !proven) {
+                markVisited(s, childKey(s, moves[i], toMove));  // draw leaf
+            }
+        } else {
+            childWins = childProven(s, moves[i], toMove);
+            if (needAll || childWins == proven) {
+                play(s, moves[i], toMove);
+                countProof(s, otherPlayer(toMove), proven);
+                undo(s, moves[i], toMove);
+            }
+        }
+        if (!needAll && childWins == proven) {
+            return;  // one matching child is enough
+        }
+    }
+}
+
+// follow best play from the root and record it in result->pv
+// value is from the point of view of toMove and flips every ply
+static void principalVariation(Solver *s, char toMove, int value, SolveResult *result) {
+    Cell moves[MAX_CELLS];
+    int drawn[MAX_CELLS];
+    uint32_t pn, dn;
+    Cell played[MAX_CELLS];
+    char players[MAX_CELLS];
+    int depth = 0;
+    int n, i, choice;
+
+    result->pvLength = 0;
+    for (;;) {
+        ThreatInfo info;
+        int me = playerIndex(toMove);
+
+        // the winner of the search is the attacker along the whole line
+        s->attacker = (value == SOLVE_WIN) ? toMove : otherPlayer(toMove);
+        n = expand(s, toMove, moves, drawn, &pn, &dn);
+        if (n == 0) {
+            // finish the line with the immediate win or the lost block
+            analyzeThreats(s->board, s->size, &info);
+            if (info.winCount[me] > 0) {
+                result->pv[result->pvLength++] = info.wins[me][0];
+            } else if (info.winCount[1 - me] > 1) {
+                result->pv[result->pvLength++] = info.wins[1 - me][0];
+                result->pv[result->pvLength++] = info.wins[1 - me][1];
+            }
+            break;
+        }
+
+        // win: a move that keeps the win; draw: a move that doesn't lose;
+        // loss: every move loses, so take the first in threat order
+        choice = 0;
+        if (value != SOLVE_LOSS) {
+            for (i = 0; i < n; i++) {
+                int attackerWins = drawn[i] ? 0 : childProven(s, moves[i], toMove);
+                if (attackerWins == (value == SOLVE_WIN)) {
+                    choice = i;
+                    break;
+                }
+            }
+        }
+
+        result->pv[result->pvLength++] = moves[choice];
+        played[depth] = moves[choice];
+        players[depth] = toMove;
+        depth++;
+        play(s, moves[choice], toMove);
+        if (drawn[choice]) {
+            break;
+        }
+        toMove = otherPlayer(toMove);
+        value = -value;
+    }
+
+    // put the board back the way the caller gave it to us
+    while (depth > 0) {
+        depth--;
+        undo(s, played[depth], players[depth]);
+    }
+}
+
+int solvePosition(char board[MAX_SIZE][MAX_SIZE], int size, char toMove,
+                  size_t memoryLimit, SolveResult *result) {
+    Solver *s;
+    uint64_t seed = 1410;
+    size_t tableEntries, visitedEntries;
+    int i, j, p;
+
+    // a finished game has nothing to search: the value is already decided
+    // (a completed line of the side to move can't come from a legal game,
+    // but is reported as its win all the same)
+    if (checkWin(board, size, 'X') || checkWin(board, size, 'O') || checkDraw(board, size)) {
+        if (checkWin(board, size, otherPlayer(toMove))) {
+            result->value = SOLVE_LOSS;
+        } else if (checkWin(board, size, toMove)) {
+            result->value = SOLVE_WIN;
+        } else {
+            result->value = SOLVE_DRAW;
+        }
+        result->nodes = 0;
+        result->proofSize = 0;
+        result->proofSizeExact = 1;
+        result->pvLength = 0;
+        return 0;
+    }
+
+    // three quarters of the budget for the table, the rest for proof counting
+    tableEntries = powerOfTwoFit(memoryLimit / 4 * 3, sizeof(TTEntry));
+    visitedEntries = powerOfTwoFit(memoryLimit / 4, sizeof(uint64_t));
+    if (tableEntries < 1024 || visitedEntries < 1024) {
+        return -1;
+    }
+
+    s = malloc(sizeof(Solver));
+    if (s == NULL) {
+        return -1;
+    }
+    s->table = calloc(tableEntries, sizeof(TTEntry));
+    s->visited = calloc(visitedEntries, sizeof(uint64_t));
+    if (s->table == NULL || s->visited == NULL) {
+        free(s->table);
+        free(s->visited);
+        free(s);
+        return -1;
+    }
+    s->tableMask = tableEntries - 1;
+    s->visitedMask = visitedEntries - 1;
+    s->visitedCount = 0;
+    s->visitedFull = 0;
+    s->nodes = 0;
+    s->proofSize = 0;
+
+    // copy the position and build its hash
+    s->size = size;
+    s->empties = 0;
+    s->hash = 0;
+    for (i = 0; i < size * size; i++) {
+        for (p = 0; p < 2; p++) {
+            s->zobrist[i][p] = splitMix64(&seed);
+        }
+    }
+    // non-zero attacker keys also keep the empty board away from the
+    // all-zero key of unused table slots
+    s->attackerKey[0] = splitMix64(&seed);
+    s->attackerKey[1] = splitMix64(&seed);
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            s->board[i][j] = board[i][j];
+            if (board[i][j] == 'X' || board[i][j] == 'O') {
+                s->hash ^= s->zobrist[i * size + j][playerIndex(board[i][j])];
+            } else {
+                s->board[i][j] = ' ';
+                s->empties++;
+            }
+        }
+    }
+
+    // search 1: can the side to move force a win?
+    s->attacker = toMove;
+    if (prove(s, toMove)) {
+        result->value = SOLVE_WIN;
+        countProof(s, toMove, 1);
+    } else {
+        // search 2: can the opponent force a win? if not, it's a draw
+        s->attacker = otherPlayer(toMove);
+        if (prove(s, toMove)) {
+            result->value = SOLVE_LOSS;
+            countProof(s, toMove, 1);
+        } else {
+            // a draw needs both disproofs
+            result->value = SOLVE_DRAW;
+            countProof(s, toMove, 0);
+            s->attacker = toMove;
+            countProof(s, toMove, 0);
+        }
+    }
+
+    principalVariation(s, toMove, result->value, result);
+    result->nodes = s->nodes;
+    result->proofSize = s->proofSize;
+    result->proofSizeExact = !s->visitedFull;
+
+    free(s->table);
+    free(s->visited);
+    free(s);
+    return 0;
+}
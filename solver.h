@@ -0,0 +1,47 @@
+// solver.h: proves the game-theoretic value of a tic-tac-toe position
+//
+// uses depth-first proof-number search (df-pn) with a fixed-size
+// transposition table, so memory use never grows past the limit given
+// by the caller. a position is solved with two searches: "can the side
+// to move force a win?" and, if not, "can the opponent force a win?".
+// neither proven means the position is a draw.
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stddef.h>
+
+#include "threats.h"
+
+// game-theoretic values, always from the point of view of the side to move
+#define SOLVE_LOSS -1
+#define SOLVE_DRAW  0
+#define SOLVE_WIN   1
+
+typedef struct {
+    int value;           // SOLVE_WIN, SOLVE_DRAW or SOLVE_LOSS
+    long nodes;          // positions expanded by the proof-number searches
+    long proofSize;      // distinct positions in the proof (and disproof) tree
+    int proofSizeExact;  // 0 if the tree outgrew memory and proofSize is a lower bound
+    Cell pv[MAX_CELLS];  // principal variation starting with the side to move
+    int pvLength;
+} SolveResult;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// solve a position with toMove ('X' or 'O') to play next
+// memoryLimit is the total number of bytes the solver may allocate
+// a position that is already over (a completed line or a full board) is
+// not searched: it gets its decided value (SOLVE_LOSS when the opponent
+// has a line), zero nodes and an empty principal variation
+// returns 0 on success, -1 if the memory limit is too small or malloc fails
+int solvePosition(char board[MAX_SIZE][MAX_SIZE], int size, char toMove,
+                  size_t memoryLimit, SolveResult *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
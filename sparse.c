@@ -0,0 +1,447 @@
+// sparse.c: hash-set board for unbounded k-in-a-row games
+//
+// cells are packed into one 64-bit key (row in the high half, column in
+// the low half) and mixed before probing, so neighbouring cells land in
+// unrelated slots. the table doubles when it gets half full and uses
+// linear probing with backward-shift deletion, so undo never leaves
+// tombstones behind.
+
+#include <stdlib.h>
+
+#include "engine.h"
+#include "sparse.h"
+#include "threatspace.h"
+
+#define INITIAL_CAPACITY 64 // slots in a new table (power of two)
+#define AI_THREATS       8     // forcing moves the ai's threat search may use
+#define AI_THREAT_NODES  2000  // positions per threat search (a few ms)
+#define AI_SPOIL_TRIES   6     // cells of the opponent's forcing line tried as defences
+
+// the four line directions: horizontal, vertical and both diagonals
+static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+static uint64_t packCell(int row, int col) {
+    return ((uint64_t)(uint32_t)row << 32) | (uint32_t)col;
+}
+
+static Cell unpackCell(uint64_t key) {
+    Cell cell;
+    cell.row = (int)(int32_t)(uint32_t)(key >> 32);
+    cell.col = (int)(int32_t)(uint32_t)key;
+    return cell;
+}
+
+// splitmix64 finalizer: spreads nearby coordinates over the table
+static size_t hashKey(uint64_t key, size_t capacity) {
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return (size_t)key & (capacity - 1);
+}
+
+static int tableInit(CellTable *table, size_t capacity) {
+    table->keys = malloc(capacity * sizeof(uint64_t));
+    table->values = calloc(capacity, sizeof(char));
+    if (table->keys == NULL || table->values == NULL) {
+        free(table->keys);
+        free(table->values);
+        table->keys = NULL;
+        table->values = NULL;
+        return -1;
+    }
+    table->capacity = capacity;
+    table->count = 0;
+    return 0;
+}
+
+static void tableFree(CellTable *table) {
+    free(table->keys);
+    free(table->values);
+    table->keys = NULL;
+    table->values = NULL;
+}
+
+static void tableClear(CellTable *table) {
+    size_t i;
+    for (i = 0; i < table->capacity; i++) {
+        table->values[i] = 0;
+    }
+    table->count = 0;
+}
+
+// slot holding key, or the free slot where it would go
+static size_t tableFind(const CellTable *table, uint64_t key) {
+    size_t slot = hashKey(key, table->capacity);
+    while (table->values[slot] != 0 && table->keys[slot] != key) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    return slot;
+}
+
+static char tableGet(const CellTable *table, uint64_t key) {
+    return table->values[tableFind(table, key)];
+}
+
+// rebuild the table at twice the size; returns -1 if out of memory
+static int tableGrow(CellTable *table) {
+    CellTable bigger;
+    size_t i;
+
+    if (tableInit(&bigger, table->capacity * 2) != 0) {
+        return -1;
+    }
+    for (i = 0; i < table->capacity; i++) {
+        if (table->values[i] != 0) {
+            size_t slot = tableFind(&bigger, table->keys[i]);
+            bigger.keys[slot] = table->keys[i];
+            bigger.values[slot] = table->values[i];
+            bigger.count++;
+        }
+    }
+    tableFree(table);
+    *table = bigger;
+    return 0;
+}
+
+// insert or overwrite key; returns 1 if it was new, 0 if it existed,
+// -1 if the table could not grow
+static int tablePut(CellTable *table, uint64_t key, char value) {
+    size_t slot;
+
+    if ((table->count + 1) * 2 > table->capacity && tableGrow(table) != 0) {
+        return -1;
+    }
+    slot = tableFind(table, key);
+    if (table->values[slot] != 0) {
+        table->values[slot] = value;
+        return 0;
+    }
+    table->keys[slot] = key;
+    table->values[slot] = value;
+    table->count++;
+    return 1;
+}
+
+// delete key, shifting later entries of the probe run back into the gap
+static void tableRemove(CellTable *table, uint64_t key) {
+    size_t mask = table->capacity - 1;
+    size_t gap = tableFind(table, key);
+    size_t slot = gap;
+
+    if (table->values[gap] == 0) {
+        return;
+    }
+    for (;;) {
+        size_t home;
+        slot = (slot + 1) & mask;
+        if (table->values[slot] == 0) {
+            break;
+        }
+        // move the entry back only if the gap lies on its probe path
+        home = hashKey(table->keys[slot], table->capacity);
+        if (((slot - home) & mask) >= ((slot - gap) & mask)) {
+            table->keys[gap] = table->keys[slot];
+            table->values[gap] = table->values[slot];
+            gap = slot;
+        }
+    }
+    table->values[gap] = 0;
+    table->count--;
+}
+
+// start an empty board where winLength marks in a row win
+// returns 0, or -1 if winLength < 2 or memory runs out
+int sparseInit(SparseBoard *board, int winLength) {
+    if (winLength < 2) {
+        return -1;
+    }
+    if (tableInit(&board->stones, INITIAL_CAPACITY) != 0) {
+        return -1;
+    }
+    if (tableInit(&board->scratch, INITIAL_CAPACITY) != 0) {
+        tableFree(&board->stones);
+        return -1;
+    }
+    board->winLength = winLength;
+    board->toMove = 'X';
+    board->result = ' ';
+    board->moveCount = 0;
+    board->last.row = board->last.col = 0;
+    board->minRow = board->maxRow = 0;
+    board->minCol = board->maxCol = 0;
+    return 0;
+}
+
+void sparseFree(SparseBoard *board) {
+    tableFree(&board->stones);
+    tableFree(&board->scratch);
+}
+
+// ' ' for an empty cell, otherwise 'X' or 'O'
+char sparseGet(const SparseBoard *board, int row, int col) {
+    char value = tableGet(&board->stones, packCell(row, col));
+    return (value == 0) ? ' ' : value;
+}
+
+// copy the cells of player's stones into stones (at most maxStones)
+// returns the number written
+int sparseStones(const SparseBoard *board, char player, Cell stones[], int maxStones) {
+    const CellTable *table = &board->stones;
+    int n = 0;
+    size_t i;
+
+    for (i = 0; i < table->capacity && n < maxStones; i++) {
+        if (table->values[i] == player) {
+            stones[n++] = unpackCell(table->keys[i]);
+        }
+    }
+    return n;
+}
+
+// number of player's marks in a row starting next to (row, col) and
+// walking in direction (dRow, dCol); the cell itself is not counted
+int sparseLineLength(const SparseBoard *board, int row, int col, char player, int dRow, int dCol) {
+    int length = 0;
+
+    row += dRow;
+    col += dCol;
+    while (tableGet(&board->stones, packCell(row, col)) == player) {
+        length++;
+        row += dRow;
+        col += dCol;
+    }
+    return length;
+}
+
+// would player have winLength in a row through (row, col)?
+// probes outwards along the four directions only, never the whole board
+int sparseCompletesLine(const SparseBoard *board, int row, int col, char player) {
+    int d;
+
+    for (d = 0; d < 4; d++) {
+        int dRow = directions[d][0], dCol = directions[d][1];
+        int length = 1
+                     + sparseLineLength(board, row, col, player, dRow, dCol)
+                     + sparseLineLength(board, row, col, player, -dRow, -dCol);
+        if (length >= board->winLength) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// place the mark of the player to move at (row, col)
+// returns MOVE_OK, MOVE_OCCUPIED, MOVE_GAME_OVER or MOVE_NO_MEMORY
+int sparsePlay(SparseBoard *board, int row, int col) {
+    uint64_t key = packCell(row, col);
+    char player = board->toMove;
+
+    if (board->result != ' ') {
+        return MOVE_GAME_OVER;
+    }
+    if (tableGet(&board->stones, key) != 0) {
+        return MOVE_OCCUPIED;
+    }
+    if (tablePut(&board->stones, key, player) < 0) {
+        return MOVE_NO_MEMORY;
+    }
+
+    if (board->moveCount == 0) {
+        board->minRow = board->maxRow = row;
+        board->minCol = board->maxCol = col;
+    } else {
+        if (row < board->minRow) board->minRow = row;
+        if (row > board->maxRow) board->maxRow = row;
+        if (col < board->minCol) board->minCol = col;
+        if (col > board->maxCol) board->maxCol = col;
+    }
+    board->moveCount++;
+    board->last.row = row;
+    board->last.col = col;
+    if (sparseCompletesLine(board, row, col, player)) {
+        board->result = player;
+    }
+    board->toMove = (player == 'X') ? 'O' : 'X';
+    return MOVE_OK;
+}
+
+// take back the stone at (row, col), which should be the last one played
+// the turn goes back to that stone's owner and the game is open again;
+// last and the bounding box are not rewound
+// returns MOVE_OK, or MOVE_EMPTY if there is no stone at (row, col)
+int sparseUndo(SparseBoard *board, int row, int col) {
+    uint64_t key = packCell(row, col);
+    char player = tableGet(&board->stones, key);
+
+    if (player == 0) {
+        return MOVE_EMPTY;
+    }
+    tableRemove(&board->stones, key);
+    board->moveCount--;
+    board->toMove = player;
+    board->result = ' ';
+    return MOVE_OK;
+}
+
+// list every empty cell within radius (king moves) of some stone
+// an empty board offers just (0, 0). returns the number of cells written
+// (at most maxMoves), or -1 if memory runs out
+int sparseCandidates(SparseBoard *board, int radius, Cell moves[], int maxMoves) {
+    const CellTable *stones = &board->stones;
+    int n = 0;
+    size_t i;
+
+    if (board->moveCount == 0) {
+        if (maxMoves < 1) return 0;
+        moves[0].row = 0;
+        moves[0].col = 0;
+        return 1;
+    }
+
+    tableClear(&board->scratch);
+    for (i = 0; i < stones->capacity && n < maxMoves; i++) {
+        Cell stone;
+        int dRow, dCol;
+
+        if (stones->values[i] == 0) {
+            continue;
+        }
+        stone = unpackCell(stones->keys[i]);
+        for (dRow = -radius; dRow <= radius && n < maxMoves; dRow++) {
+            for (dCol = -radius; dCol <= radius && n < maxMoves; dCol++) {
+                int row = stone.row + dRow, col = stone.col + dCol;
+                uint64_t key = packCell(row, col);
+                int added;
+
+                if (tableGet(stones, key) != 0) {
+                    continue;                      // occupied
+                }
+                added = tablePut(&board->scratch, key, 1);
+                if (added < 0) {
+                    return -1;
+                }
+                if (added) {
+                    moves[n].row = row;
+                    moves[n].col = col;
+                    n++;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+// how useful is (row, col) for the player to move? longest own run it
+// extends plus longest opponent run it cuts, over the four directions
+static int scoreCandidate(const SparseBoard *board, int row, int col) {
+    char me = board->toMove;
+    char them = (me == 'X') ? 'O' : 'X';
+    int best = 0, score = 0, d;
+
+    for (d = 0; d < 4; d++) {
+        int dRow = directions[d][0], dCol = directions[d][1];
+        int mine = sparseLineLength(board, row, col, me, dRow, dCol)
+                   + sparseLineLength(board, row, col, me, -dRow, -dCol);
+        int theirs = sparseLineLength(board, row, col, them, dRow, dCol)
+                     + sparseLineLength(board, row, col, them, -dRow, -dCol);
+        // own runs count a little more than opponent runs of the same length
+        int value = mine * 4 + theirs * 3;
+        score += value;
+        if (value > best) best = value;
+    }
+    return best * 8 + score;
+}
+
+// the opponent has the forced win in threat: try the cells of its main
+// line (the opponent's threats and the replies to them) and take the
+// first one after which the opponent's search finds nothing. move keeps
+// the opponent's first threat cell if none of them does.
+static void spoilThreat(SparseBoard *board, const ThreatSearchResult *threat, Cell *move) {
+    char them = (board->toMove == 'X') ? 'O' : 'X';
+    ThreatSearchResult again;
+    Cell last = board->last;
+    int i, refuted;
+
+    for (i = 0; i < threat->length && i < AI_SPOIL_TRIES; i++) {
+        Cell cell = threat->line[i];
+        if (sparsePlay(board, cell.row, cell.col) != MOVE_OK) {
+            continue;
+        }
+        refuted = (board->result == ' ')
+                  && threatSpaceSearch(board, them, AI_THREATS, AI_THREAT_NODES, &again) == 0;
+        sparseUndo(board, cell.row, cell.col);
+        board->last = last;
+        if (refuted) {
+            *move = cell;
+            return;
+        }
+    }
+}
+
+// pick a move for the player to move among the candidates near the stones
+// returns AI_MOVE_WIN, AI_MOVE_BLOCK, AI_MOVE_THREAT (start of a forced
+// win), AI_MOVE_THREAT_BLOCK (first forcing move of the opponent's forced
+// win, taken away from them) or AI_MOVE_POSITIONAL (best-scoring quiet
+// move); -1 if the game is over or memory runs out
+int sparseChooseMove(SparseBoard *board, int radius, Cell *move) {
+    char me = board->toMove;
+    char them = (me == 'X') ? 'O' : 'X';
+    int side = 2 * radius + 1;
+    int maxMoves, n, i, bestScore = -1, reason = AI_MOVE_POSITIONAL;
+    Cell *moves;
+    ThreatSearchResult threat;
+
+    if (board->result != ' ') {
+        return -1;
+    }
+    maxMoves = (int)(board->stones.count + 1) * side * side;
+    moves = malloc(maxMoves * sizeof(Cell));
+    if (moves == NULL) {
+        return -1;
+    }
+    n = sparseCandidates(board, radius, moves, maxMoves);
+    if (n <= 0) {
+        free(moves);
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        int row = moves[i].row, col = moves[i].col;
+        int score;
+
+        // strategy 1: win now; strategy 2: block the opponent's win
+        if (sparseCompletesLine(board, row, col, me)) {
+            *move = moves[i];
+            reason = AI_MOVE_WIN;
+            break;
+        }
+        if (reason != AI_MOVE_BLOCK && sparseCompletesLine(board, row, col, them)) {
+            *move = moves[i];
+            reason = AI_MOVE_BLOCK;      // keep looking in case we can win
+            continue;
+        }
+        if (reason == AI_MOVE_POSITIONAL) {
+            score = scoreCandidate(board, row, col);
+            if (score > bestScore) {
+                bestScore = score;
+                *move = moves[i];
+            }
+        }
+    }
+    free(moves);
+
+    // no win or block: look for a forcing sequence, ours first
+    if (reason == AI_MOVE_POSITIONAL) {
+        if (threatSpaceSearch(board, me, AI_THREATS, AI_THREAT_NODES, &threat) > 0) {
+            *move = threat.move;
+            reason = AI_MOVE_THREAT;
+        } else if (threatSpaceSearch(board, them, AI_THREATS, AI_THREAT_NODES, &threat) > 0) {
+            *move = threat.move;
+            reason = AI_MOVE_THREAT_BLOCK;
+            spoilThreat(board, &threat, move);
+        }
+    }
+    return reason;
+}
@@ -0,0 +1,63 @@
+// sparse.h: unbounded k-in-a-row board stored as a hash table of stones
+//
+// the regular Game keeps a dense MAX_SIZE x MAX_SIZE array, which caps
+// the board at 10x10 and costs the same memory however few marks are on
+// it. a SparseBoard only stores the occupied cells, in an open-addressing
+// hash table keyed by the packed (row, col) pair, so memory grows with
+// the number of stones placed and coordinates may be any int (negative
+// ones included). a player wins with winLength or more marks in a row
+// horizontally, vertically or diagonally; the check only probes the four
+// directions through the last stone.
+//
+// sparsePlay and sparseUndo return the MOVE_* codes of engine.h:
+// sparsePlay gives MOVE_OCCUPIED, MOVE_GAME_OVER or MOVE_NO_MEMORY, and
+// sparseUndo gives MOVE_EMPTY when there is no stone to take back.
+
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "threats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// open-addressing table from packed cell to 'X' / 'O' (0 marks a free slot)
+typedef struct {
+    uint64_t *keys;
+    char *values;
+    size_t capacity;  // always a power of two
+    size_t count;
+} CellTable;
+
+typedef struct {
+    CellTable stones;   // every occupied cell
+    CellTable scratch;  // reused by sparseCandidates to drop duplicates
+    int winLength;      // marks in a row needed to win (k)
+    char toMove;        // 'X' starts
+    char result;        // ' ' while playing, 'X'/'O' winner ('D' is never reached)
+    long moveCount;
+    Cell last;          // most recent stone
+    int minRow, maxRow; // bounding box of every stone ever placed
+    int minCol, maxCol;
+} SparseBoard;
+
+int sparseInit(SparseBoard *board, int winLength);
+void sparseFree(SparseBoard *board);
+char sparseGet(const SparseBoard *board, int row, int col);
+int sparseStones(const SparseBoard *board, char player, Cell stones[], int maxStones);
+int sparsePlay(SparseBoard *board, int row, int col);
+int sparseUndo(SparseBoard *board, int row, int col);
+int sparseLineLength(const SparseBoard *board, int row, int col, char player, int dRow, int dCol);
+int sparseCompletesLine(const SparseBoard *board, int row, int col, char player);
+int sparseCandidates(SparseBoard *board, int radius, Cell moves[], int maxMoves);
+int sparseChooseMove(SparseBoard *board, int radius, Cell *move);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
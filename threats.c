@@ -0,0 +1,249 @@
+// threats.c: line threat detection used by the ai
+//
+// both players are handled in the same pass: for every line we count x
+// marks, o marks and empty cells. a line with exactly one empty cell and
+// size-1 marks of one player is an immediate win for that player. a line
+// with exactly two empty cells and size-2 marks of one player is a
+// "half threat": playing either empty cell turns it into a size-1 threat.
+// a cell that sits on two or more half threats of the same player is a
+// fork cell for that player.
+
+#include <string.h>
+
+#include "threats.h"
+
+// map 'X' / 'O' to the index used by ThreatInfo
+int playerIndex(char player) {
+    return (player == 'O') ? 1 : 0;
+}
+
+// scan one line starting at (row, col) and stepping by (dRow, dCol)
+// updates info in place; winSeen/forkHits (indexed by row * size + col)
+// stop a cell being listed twice when it lies on more than one line
+static void scanLine(char board[MAX_SIZE][MAX_SIZE], int size,
+                     int row, int col, int dRow, int dCol,
+                     ThreatInfo *info,
+                     unsigned char winSeen[2][MAX_CELLS],
+                     unsigned char forkHits[2][MAX_CELLS]) {
+    int countX = 0, countO = 0;  // marks of x and o on this line
+    int count[2];
+    int empties;                 // number of empty cells on this line
+    Cell empty[2];               // the empty cells of a threatening line
+    const char *cell = &board[row][col];
+    int step = dRow * MAX_SIZE + dCol;  // distance between cells in memory
+    int i, p, e;
+
+    // counting pass: no branches, so the loop stays cheap on quiet lines
+    for (i = 0; i < size; i++, cell += step) {
+        countX += (*cell == 'X');
+        countO += (*cell == 'O');
+    }
+    empties = size - countX - countO;
+
+    // only lines with one or two empty cells can hold a threat, and only
+    // if the opponent has no mark on them
+    if ((empties != 1 && empties != 2) || (countX != 0 && countO != 0)) {
+        return;
+    }
+
+    // threatening line (rare): walk it again to locate the empty cells
+    for (i = 0, e = 0; i < size; i++, row += dRow, col += dCol) {
+        if (board[row][col] == ' ') {
+            empty[e].row = row;
+            empty[e].col = col;
+            e++;
+        }
+    }
+    count[0] = countX;
+    count[1] = countO;
+
+    // one empty cell: whoever owns the rest of the line wins there
+    // (size-1 marks plus one empty means the other player has none)
+    if (empties == 1) {
+        for (p = 0; p < 2; p++) {
+            if (count[p] == size - 1) {
+                Cell cell = empty[0];
+                int index = cell.row * size + cell.col;
+                if (!winSeen[p][index]) {
+                    winSeen[p][index] = 1;
+                    info->wins[p][info->winCount[p]++] = cell;
+                }
+            }
+        }
+    }
+    // two empty cells: a half threat for the player owning the rest
+    else if (empties == 2) {
+        for (p = 0; p < 2; p++) {
+            if (count[p] == size - 2) {
+                for (e = 0; e < 2; e++) {
+                    Cell cell = empty[e];
+                    // the second half threat through a cell makes it a fork
+                    if (++forkHits[p][cell.row * size + cell.col] == 2) {
+                        info->forks[p][info->forkCount[p]++] = cell;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// find every immediate win and fork cell for both players in one pass
+void analyzeThreats(char board[MAX_SIZE][MAX_SIZE], int size, ThreatInfo *info) {
+    unsigned char winSeen[2][MAX_CELLS];
+    unsigned char forkHits[2][MAX_CELLS];
+    int cells = size * size;
+    int i;
+
+    // only clear the part of the scratch arrays this board size uses
+    memset(winSeen[0], 0, cells);
+    memset(winSeen[1], 0, cells);
+    memset(forkHits[0], 0, cells);
+    memset(forkHits[1], 0, cells);
+    info->winCount[0] = info->winCount[1] = 0;
+    info->forkCount[0] = info->forkCount[1] = 0;
+
+    for (i = 0; i < size; i++) {
+        scanLine(board, size, i, 0, 0, 1, info, winSeen, forkHits); // row i
+        scanLine(board, size, 0, i, 1, 0, info, winSeen, forkHits); // column i
+    }
+    scanLine(board, size, 0, 0, 1, 1, info, winSeen, forkHits);         // main diagonal
+    scanLine(board, size, 0, size - 1, 1, -1, info, winSeen, forkHits); // anti-diagonal
+}
+
+// fill moves with every empty cell, forcing moves first:
+// own wins, blocks, own forks, opponent forks, then the rest in board order
+// returns the number of moves written
+int orderMoves(char board[MAX_SIZE][MAX_SIZE], int size, char player,
+               const ThreatInfo *info, Cell moves[MAX_CELLS]) {
+    unsigned char taken[MAX_SIZE][MAX_SIZE];
+    const Cell *groups[4];
+    int groupCount[4];
+    int me = playerIndex(player);
+    int n = 0;
+    int g, i, j;
+
+    memset(taken, 0, sizeof(taken));
+    groups[0] = info->wins[me];      groupCount[0] = info->winCount[me];
+    groups[1] = info->wins[1 - me];  groupCount[1] = info->winCount[1 - me];
+    groups[2] = info->forks[me];     groupCount[2] = info->forkCount[me];
+    groups[3] = info->forks[1 - me]; groupCount[3] = info->forkCount[1 - me];
+
+    for (g = 0; g < 4; g++) {
+        for (i = 0; i < groupCount[g]; i++) {
+            Cell cell = groups[g][i];
+            if (!taken[cell.row][cell.col]) {
+                taken[cell.row][cell.col] = 1;
+                moves[n++] = cell;
+            }
+        }
+    }
+
+    // quiet moves: every other empty cell
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (board[i][j] == ' ' && !taken[i][j]) {
+                moves[n].row = i;
+                moves[n].col = j;
+                n++;
+            }
+        }
+    }
+    return n;
+}
+
+// check if a player can win in the next move
+// returns 1 if win is possible and sets row and col to winning position
+int canWin(char board[MAX_SIZE][MAX_SIZE], int size, char player, int *row, int *col) {
+    int i, j;
+    int count, emptyRow, emptyCol;
+    
+    // check all rows for near-complete lines
+    for (i = 0; i < size; i++) {
+        count = 0;           // count player's marks in this row
+        emptyRow = -1;       // track location of empty cell
+        emptyCol = -1;
+        
+        for (j = 0; j < size; j++) {
+            if (board[i][j] == player) {
+                count++;     // player has a mark here
+            } else if (board[i][j] == ' ') {
+                emptyRow = i;  // remember empty cell position
+                emptyCol = j;
+            }
+        }
+        
+        // if player has size-1 marks and one empty cell: winning move!
+        if (count == size - 1 && emptyRow != -1) {
+            *row = emptyRow;   // return winning position
+            *col = emptyCol;
+            return 1;          // found a winning opportunity
+        }
+    }
+    
+    // check all columns using same logic as rows
+    for (j = 0; j < size; j++) {
+        count = 0;           // reset counter for each column
+        emptyRow = -1;       // reset empty cell tracker
+        emptyCol = -1;
+        
+        for (i = 0; i < size; i++) {
+            if (board[i][j] == player) {
+                count++;     // player has a mark in this column
+            } else if (board[i][j] == ' ') {
+                emptyRow = i;  // track empty cell in this column
+                emptyCol = j;
+            }
+        }
+        
+        // if player has size-1 marks and one empty: winning move!
+        if (count == size - 1 && emptyRow != -1) {
+            *row = emptyRow;   // return the winning position
+            *col = emptyCol;
+            return 1;          // found a winning opportunity
+        }
+    }
+    
+    // check main diagonal (top-left to bottom-right)
+    count = 0;             // reset counter
+    emptyRow = -1;         // reset empty cell tracker
+    emptyCol = -1;
+    
+    for (i = 0; i < size; i++) {
+        if (board[i][i] == player) {
+            count++;       // player has mark on diagonal at (i,i)
+        } else if (board[i][i] == ' ') {
+            emptyRow = i;  // track empty cell on diagonal
+            emptyCol = i;
+        }
+    }
+    
+    // check if diagonal has size-1 marks with one empty cell
+    if (count == size - 1 && emptyRow != -1) {
+        *row = emptyRow;   // return winning position
+        *col = emptyCol;
+        return 1;          // found a winning move
+    }
+    
+    // check anti-diagonal (top-right to bottom-left)
+    count = 0;                    // reset counter
+    emptyRow = -1;                // reset empty cell tracker
+    emptyCol = -1;
+    
+    for (i = 0; i < size; i++) {
+        if (board[i][size - 1 - i] == player) {
+            count++;               // player has mark on anti-diagonal
+        } else if (board[i][size - 1 - i] == ' ') {
+            emptyRow = i;          // track empty cell on anti-diagonal
+            emptyCol = size - 1 - i;
+        }
+    }
+    
+    // check if anti-diagonal has size-1 marks with one empty cell
+    if (count == size - 1 && emptyRow != -1) {
+        *row = emptyRow;           // return winning position
+        *col = emptyCol;
+        return 1;                  // found a winning move
+    }
+    
+    return 0;
+}
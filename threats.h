@@ -0,0 +1,58 @@
+// threats.h: single-pass threat analysis for the tic-tac-toe ai
+//
+// canWin() answers "can this player win right now?" for one player and
+// stops at the first cell it finds, so the ai used to scan every line
+// twice (once for itself, once for the opponent). analyzeThreats() walks
+// every row, column and diagonal exactly once and reports, for both
+// players at the same time:
+// - every cell that completes a line (an immediate win for that player,
+//   and therefore a block cell for the other player)
+// - every fork cell: a cell that creates two size-1 threats at once,
+//   which the opponent cannot block with a single move
+//
+// the result can also be turned into a move ordering (orderMoves) so
+// search code looks at forcing moves first.
+
+#ifndef THREATS_H
+#define THREATS_H
+
+#ifndef MAX_SIZE
+#define MAX_SIZE 10 // maximum grid size
+#endif
+
+#define MAX_LINES (2 * MAX_SIZE + 2)   // rows + columns + two diagonals
+#define MAX_CELLS (MAX_SIZE * MAX_SIZE) // every cell on the largest board
+
+// a board coordinate
+typedef struct {
+    int row;
+    int col;
+} Cell;
+
+// threats for both players; index 0 is player x, index 1 is player o
+// (see playerIndex). a win cell for one player is a block cell for the
+// other, so blocks are read from the opponent's win list.
+typedef struct {
+    Cell wins[2][MAX_LINES];  // cells that complete a line, no duplicates
+    int winCount[2];
+    Cell forks[2][MAX_CELLS]; // cells that create two size-1 threats
+    int forkCount[2];
+} ThreatInfo;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int playerIndex(char player);
+void analyzeThreats(char board[MAX_SIZE][MAX_SIZE], int size, ThreatInfo *info);
+int orderMoves(char board[MAX_SIZE][MAX_SIZE], int size, char player,
+               const ThreatInfo *info, Cell moves[MAX_CELLS]);
+
+// reference implementation kept for comparison and benchmarking
+int canWin(char board[MAX_SIZE][MAX_SIZE], int size, char player, int *row, int *col);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
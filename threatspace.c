@@ -0,0 +1,345 @@
+// threatspace.c: forcing-move search for k-in-a-row (see threatspace.h)
+//
+// an and/or search: the attacker (or node) plays fours and open threes,
+// the defender (and node) must answer every threat left on the board.
+// the stones around the action are copied out of the SparseBoard into a
+// dense grid once, so the search itself reads plain array cells instead
+// of probing the hash table, and keeps a list of each player's stones.
+// threats are found by sliding a k or k+1 cell segment along the four
+// directions through each stone of a player, so a node costs a few dozen
+// array reads per stone and nothing per empty cell.
+
+#include <stdlib.h>
+
+#include "threatspace.h"
+
+#define MAX_SEGMENT 32   // longest segment (k + 1) the search handles
+#define MAX_REPLIES 128  // moves considered at one node
+#define MAX_GRID    (1 << 22)  // cells in the dense copy; stones spread wider aren't searched
+
+static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+typedef struct {
+    char attacker;
+    char defender;
+    int k;
+    long nodes;
+    long maxNodes;
+    int threes;         // 0: fours only, 1: fours and open threes
+    // dense copy of the board: cell (row, col) is grid[(row - top) * width + col - left]
+    char *grid;
+    int top, left, width, height;
+    int margin;         // moves must stay this far inside the grid
+    unsigned *listed;   // per grid cell: generation of the move list it was added to
+    unsigned generation;
+    Cell *stones[2];    // each player's stones ([playerIndex])
+    int stoneCount[2];
+    Cell line[TSS_MAX_PLIES];
+    int length;
+} Search;
+
+// place a stone; returns 0 for cells too close to the edge of the grid
+static int place(Search *s, Cell cell, char player) {
+    int p = playerIndex(player);
+
+    if (cell.row - s->top < s->margin || cell.row - s->top >= s->height - s->margin
+        || cell.col - s->left < s->margin || cell.col - s->left >= s->width - s->margin) {
+        return 0;
+    }
+    s->grid[(cell.row - s->top) * s->width + cell.col - s->left] = player;
+    s->stones[p][s->stoneCount[p]++] = cell;
+    return 1;
+}
+
+// take back the stone placed last by player
+static void unplace(Search *s, Cell cell, char player) {
+    s->grid[(cell.row - s->top) * s->width + cell.col - s->left] = ' ';
+    s->stoneCount[playerIndex(player)]--;
+}
+
+// start a new move list: no cell counts as listed any more
+static void startList(Search *s, int *count) {
+    s->generation++;
+    *count = 0;
+}
+
+// add cell to the current list unless it is already there
+// (cells outside the grid are never played, so they are skipped)
+// returns 0 if the list is full
+static int addCell(Search *s, Cell list[], int *count, Cell cell) {
+    int row = cell.row - s->top, col = cell.col - s->left;
+    unsigned *listed;
+
+    if (row < 0 || row >= s->height || col < 0 || col >= s->width) {
+        return 1;
+    }
+    listed = &s->listed[row * s->width + col];
+    if (*listed == s->generation) {
+        return 1;
+    }
+    if (*count == MAX_REPLIES) {
+        return 0;
+    }
+    *listed = s->generation;
+    list[(*count)++] = cell;
+    return 1;
+}
+
+// find every segment of length cells in a row that holds exactly mine of
+// player's stones and none of the opponent's. with open, the first and
+// last cell must be empty and don't count; they are added to out only if
+// withEnds is set. the other empty cells of each segment are added to out,
+// which must have been started with startList.
+// returns 0 if out overflowed
+static int collectSegments(Search *s, char player, int length, int mine, int open, int withEnds,
+                           Cell out[], int *count) {
+    char other = (player == 'X') ? 'O' : 'X';
+    int p = playerIndex(player);
+    char cells[2 * MAX_SEGMENT];
+    int own[2 * MAX_SEGMENT + 1], theirs[2 * MAX_SEGMENT + 1];  // prefix counts
+    int first = open ? 1 : 0, last = open ? length - 2 : length - 1;
+    int i, d, o, start, c;
+
+    for (i = 0; i < s->stoneCount[p]; i++) {
+        Cell stone = s->stones[p][i];
+        const char *centre = &s->grid[(stone.row - s->top) * s->width + stone.col - s->left];
+
+        for (d = 0; d < 4; d++) {
+            int dRow = directions[d][0], dCol = directions[d][1];
+            int stride = dRow * s->width + dCol;
+            const char *cell = centre - (length - 1) * stride;
+
+            // the 2*length-1 cells centred on the stone cover every segment
+            // through it (stones stay margin > length-1 cells inside the grid)
+            own[0] = theirs[0] = 0;
+            for (o = 0; o < 2 * length - 1; o++, cell += stride) {
+                cells[o] = *cell;
+                own[o + 1] = own[o] + (*cell == player);
+                theirs[o + 1] = theirs[o] + (*cell == other);
+            }
+            // segment cells[start .. start+length-1]; the stone sits at length-1
+            for (start = 0; start < length; start++) {
+                const char *segment = &cells[start];
+
+                if (open && (start == 0 || start == length - 1
+                             || segment[0] != ' ' || segment[length - 1] != ' ')) {
+                    continue;  // the stone must be inside, the ends empty
+                }
+                if (own[start + last + 1] - own[start + first] != mine
+                    || theirs[start + last + 1] - theirs[start + first] != 0) {
+                    continue;
+                }
+                for (c = 0; c < length; c++) {
+                    int step = start + c - (length - 1);
+                    Cell cell;
+                    if (segment[c] != ' ' || (!withEnds && (c < first || c > last))) {
+                        continue;
+                    }
+                    cell.row = stone.row + step * dRow;
+                    cell.col = stone.col + step * dCol;
+                    if (!addCell(s, out, count, cell)) {
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+// cells where player would complete k in a row
+static void winningCells(Search *s, char player, Cell out[], int *count) {
+    startList(s, count);
+    collectSegments(s, player, s->k, s->k - 1, 0, 0, out, count);
+}
+
+static int defenderNode(Search *s, int threats, int ply);
+
+// attacker to move with threats forcing moves left
+// returns 1 if the attacker can force a win
+static int attackerNode(Search *s, int threats, int ply) {
+    Cell moves[MAX_REPLIES];
+    int count, i;
+
+    if (++s->nodes > s->maxNodes) {
+        return 0;
+    }
+
+    // win on the spot
+    winningCells(s, s->attacker, moves, &count);
+    if (count > 0) {
+        s->line[ply] = moves[0];
+        s->length = ply + 1;
+        return 1;
+    }
+    if (threats == 0) {
+        return 0;
+    }
+
+    // a four of the defender must be blocked first (two can't be)
+    winningCells(s, s->defender, moves, &count);
+    if (count > 1) {
+        return 0;
+    }
+    if (count == 0) {
+        // fours first: they leave the defender a single reply
+        startList(s, &count);
+        collectSegments(s, s->attacker, s->k, s->k - 2, 0, 0, moves, &count);
+        if (s->threes && s->k >= 4) {
+            collectSegments(s, s->attacker, s->k + 1, s->k - 3, 1, 0, moves, &count);
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        int won;
+        if (!place(s, moves[i], s->attacker)) {
+            continue;
+        }
+        s->line[ply] = moves[i];
+        won = defenderNode(s, threats - 1, ply + 1);
+        unplace(s, moves[i], s->attacker);
+        if (won) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// defender to move; returns 1 if every reply still loses
+static int defenderNode(Search *s, int threats, int ply) {
+    Cell replies[MAX_REPLIES];
+    int count, i;
+
+    if (++s->nodes > s->maxNodes) {
+        return 0;
+    }
+
+    winningCells(s, s->defender, replies, &count);
+    if (count > 0) {
+        return 0;                  // the defender wins first
+    }
+    winningCells(s, s->attacker, replies, &count);
+    if (count > 1) {
+        s->length = ply;           // two fours: only one can be blocked
+        return 1;
+    }
+    if (count == 0) {
+        if (!s->threes) {
+            return 0;
+        }
+        // answer the open threes: their gaps and ends, or a counter-four
+        startList(s, &count);
+        if (!collectSegments(s, s->attacker, s->k + 1, s->k - 2, 1, 1, replies, &count)) {
+            return 0;              // too many replies to check them all
+        }
+        if (count == 0) {
+            return 0;              // no threat left: the attack has run out
+        }
+        if (!collectSegments(s, s->defender, s->k, s->k - 2, 0, 0, replies, &count)) {
+            return 0;
+        }
+    }
+
+    // last reply first, so the main line left in s->line is that of replies[0]
+    for (i = count - 1; i >= 0; i--) {
+        int won;
+        if (!place(s, replies[i], s->defender)) {
+            return 0;              // off the grid: can't prove this reply loses
+        }
+        s->line[ply] = replies[i];
+        won = attackerNode(s, threats, ply + 1);
+        unplace(s, replies[i], s->defender);
+        if (!won) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// look for a forced win of attacker using at most maxThreats of its moves
+// (as if it were attacker's turn) and at most maxNodes positions.
+// returns 1 if a win was found, 0 if not (or k is outside 3..MAX_SEGMENT-1,
+// or the stones are spread over too large an area), -1 if out of memory
+int threatSpaceSearch(const SparseBoard *board, char attacker, int maxThreats, long maxNodes,
+                      ThreatSearchResult *result) {
+    Search s;
+    int count = (int)board->stones.count;
+    int reach, p, i, found = 0;
+
+    result->found = 0;
+    result->length = 0;
+    result->nodes = 0;
+    if (board->result != ' ' || board->moveCount == 0
+        || board->winLength < 3 || board->winLength + 1 > MAX_SEGMENT) {
+        return 0;
+    }
+    if (maxThreats > (TSS_MAX_PLIES - 1) / 2) {
+        maxThreats = (TSS_MAX_PLIES - 1) / 2;
+    }
+
+    s.attacker = attacker;
+    s.defender = (attacker == 'X') ? 'O' : 'X';
+    s.k = board->winLength;
+    s.nodes = 0;
+    s.maxNodes = maxNodes;
+    s.length = 0;
+
+    // the grid covers every stone plus room for the forcing lines to grow
+    // (each move lands within k of a stone) and a border for the scans
+    s.margin = s.k + 1;
+    reach = s.k * 4 + s.margin;
+    s.top = board->minRow - reach;
+    s.left = board->minCol - reach;
+    s.height = board->maxRow - board->minRow + 1 + 2 * reach;
+    s.width = board->maxCol - board->minCol + 1 + 2 * reach;
+    if ((double)s.width * s.height > MAX_GRID) {
+        return 0;
+    }
+    s.grid = malloc((size_t)s.width * s.height);
+    s.listed = calloc((size_t)s.width * s.height, sizeof(unsigned));
+    s.generation = 0;
+    s.stones[0] = malloc((count + TSS_MAX_PLIES) * sizeof(Cell));
+    s.stones[1] = malloc((count + TSS_MAX_PLIES) * sizeof(Cell));
+    if (s.grid == NULL || s.listed == NULL || s.stones[0] == NULL || s.stones[1] == NULL) {
+        free(s.grid);
+        free(s.listed);
+        free(s.stones[0]);
+        free(s.stones[1]);
+        return -1;
+    }
+    for (i = 0; i < s.width * s.height; i++) {
+        s.grid[i] = ' ';
+    }
+    for (p = 0; p < 2; p++) {
+        char player = (p == 0) ? 'X' : 'O';
+        s.stoneCount[p] = sparseStones(board, player, s.stones[p], count);
+        for (i = 0; i < s.stoneCount[p]; i++) {
+            Cell stone = s.stones[p][i];
+            s.grid[(stone.row - s.top) * s.width + stone.col - s.left] = player;
+        }
+    }
+
+    // fours alone first: one reply per threat keeps that search narrow and
+    // deep; the open threes get whatever is left of the node budget
+    s.threes = 0;
+    found = attackerNode(&s, maxThreats, 0);
+    if (!found && s.nodes < maxNodes) {
+        s.threes = 1;
+        found = attackerNode(&s, maxThreats, 0);
+    }
+
+    free(s.grid);
+    free(s.listed);
+    free(s.stones[0]);
+    free(s.stones[1]);
+    result->nodes = s.nodes;
+    if (found) {
+        result->found = 1;
+        result->move = s.line[0];
+        result->length = s.length;
+        for (i = 0; i < s.length; i++) {
+            result->line[i] = s.line[i];
+        }
+    }
+    return found;
+}
@@ -0,0 +1,45 @@
+// threatspace.h: threat-space search for k-in-a-row on a SparseBoard
+//
+// a full-width search on a large board spends nearly all of its effort
+// on quiet moves. threat-space search only tries the attacker's forcing
+// moves, the same idea as the size-1 line threats of analyzeThreats but
+// for any k and any k-cell segment of a line (gaps allowed):
+// - four: k-1 of the attacker's stones and one empty cell in a k-cell
+//   segment with no defender stone; the defender must take that cell
+// - open three: k-2 stones and one empty cell in the middle k-1 cells of
+//   a (k+1)-cell segment whose two end cells are empty; filling the gap
+//   makes a four that can be completed at either end
+// (the names come from gomoku, k = 5.) the defender is only given the
+// replies that can stop the threats on the board: the empty cells of the
+// threatening segments, or a move that makes a four of its own. like
+// allis' original search it assumes any other reply loses, so a reported
+// win is forced unless the defender can ignore an open three and build a
+// faster counter-attack out of its own open threes.
+
+#ifndef THREATSPACE_H
+#define THREATSPACE_H
+
+#include "sparse.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TSS_MAX_PLIES 64  // longest forcing line (attacker and defender moves)
+
+typedef struct {
+    int found;                 // 1 if the attacker has a forced win
+    Cell move;                 // the attacker's first move of that win
+    Cell line[TSS_MAX_PLIES];  // main line: attacker, defender, attacker, ...
+    int length;                // moves in line
+    long nodes;                // positions searched
+} ThreatSearchResult;
+
+int threatSpaceSearch(const SparseBoard *board, char attacker, int maxThreats, long maxNodes,
+                      ThreatSearchResult *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
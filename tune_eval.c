@@ -0,0 +1,147 @@
+// tune_eval.c: tunes the evaluation weights of one board size by playing
+// them against the random AI_EASY player
+//
+// hill climbing on the weights of the pattern-table evaluator: each round
+// scales one weight up or down and plays the candidate and the current
+// weights through the same match of AI_HARD-style searches against the
+// random AI_EASY player (searcher against searcher is a draw nearly every
+// game, which says nothing about the weights). game i of both matches
+// uses random stream i, so the two see the same openings for as long as
+// their moves agree. a win scores 1 plus the share of the board still
+// empty, so quicker wins count more; a draw 1/2. the change is kept if the
+// candidate scores higher. the result is written in the format read by
+// evalParseWeights, e.g. weights/4.txt, which mainp2's hard level loads.
+//
+// usage: ./tune_eval --size N [--rounds R] [--games G] [--depth D]
+//                    [--seed S] [--out weights/N.txt]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "eval.h"
+
+// score of table over games games against AI_EASY (half of them as x)
+static double playMatch(int size, const EvalTable *table, int games, int depth,
+                        uint64_t seed, uint64_t firstStream) {
+    double points = 0;
+    int g;
+
+    for (g = 0; g < games; g++) {
+        char searcher = (g % 2 == 0) ? 'X' : 'O';
+        Game game;
+        Cell move;
+
+        gameInit(&game, size);
+        gameSeed(&game, seed, firstStream + g);
+        while (game.result == ' ') {
+            if (game.toMove == searcher) {
+                gameSearchMove(&game, table, depth, &move);
+            } else {
+                gameChooseAiMove(&game, AI_EASY, NULL, &move);
+            }
+            gameApplyMove(&game, move.row, move.col);
+        }
+        if (game.result == searcher) {
+            points += 1 + (double)(size * size - game.moveCount) / (size * size);
+        } else if (game.result == 'D') {
+            points += 0.5;
+        }
+    }
+    return points;
+}
+
+static int writeWeights(const char *path, int size, const int weights[], int games, uint64_t seed) {
+    FILE *out = fopen(path, "w");
+    int n;
+
+    if (out == NULL) {
+        return -1;
+    }
+    fprintf(out, "# evaluation weights for %dx%d, tuned by tune_eval (%d games per round, seed %llu)\n",
+            size, size, games, (unsigned long long)seed);
+    fprintf(out, "# marks on an open line -> score\n");
+    for (n = 1; n <= size; n++) {
+        fprintf(out, "%d %d\n", n, weights[n]);
+    }
+    fclose(out);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int size = 0, rounds = 40, games = 200, depth = 2;
+    uint64_t seed = 1;
+    char defaultOut[32];
+    const char *outFile = NULL;
+    int weights[MAX_SIZE + 1], trial[MAX_SIZE + 1];
+    EvalTable current, candidate;
+    Rng rng;
+    uint64_t stream = 0;
+    int round, i, accepted = 0;
+
+    for (i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--size") == 0) size = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--rounds") == 0) rounds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--games") == 0) games = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--depth") == 0) depth = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--out") == 0) outFile = argv[i + 1];
+    }
+    if (size < 3 || size > MAX_SIZE || games < 2 || depth < 1) {
+        printf("usage: ./tune_eval --size N [--rounds R] [--games G] [--depth D] [--seed S] [--out FILE]\n");
+        return 1;
+    }
+    if (outFile == NULL) {
+        sprintf(defaultOut, "weights/%d.txt", size);
+        outFile = defaultOut;
+    }
+
+    evalDefaultWeights(size, weights);
+    rngSeed(&rng, seed);
+    if (evalTableInit(&current, size, weights) != 0) {
+        printf("Out of memory.\n");
+        return 1;
+    }
+
+    for (round = 1; round <= rounds; round++) {
+        // scale one weight (a line one mark short of full is the highest that matters)
+        int n = 1 + rngBelow(&rng, size - 1);
+        int up = rngBelow(&rng, 2);
+        double before, after;
+
+        memcpy(trial, weights, sizeof(trial));
+        trial[n] = up ? trial[n] * 3 / 2 + 1 : trial[n] * 2 / 3;
+        if (trial[n] > EVAL_MAX_WEIGHT) {
+            trial[n] = EVAL_MAX_WEIGHT;  // evalTableInit and evalParseWeights reject more
+        }
+        if (evalTableInit(&candidate, size, trial) != 0) {
+            printf("Out of memory.\n");
+            return 1;
+        }
+        before = playMatch(size, &current, games, depth, seed, stream);
+        after = playMatch(size, &candidate, games, depth, seed, stream);
+        stream += games;
+
+        printf("round %2d: weight %d %6d -> %6d  score %7.2f -> %7.2f", round, n,
+               weights[n], trial[n], before, after);
+        if (after > before) {
+            memcpy(weights, trial, sizeof(weights));
+            evalTableFree(&current);
+            current = candidate;
+            accepted++;
+            printf("  kept\n");
+        } else {
+            evalTableFree(&candidate);
+            printf("\n");
+        }
+    }
+    evalTableFree(&current);
+
+    if (writeWeights(outFile, size, weights, games, seed) != 0) {
+        printf("Could not write %s\n", outFile);
+        return 1;
+    }
+    printf("%d of %d changes kept; weights written to %s\n", accepted, rounds, outFile);
+    return 0;
+}